@@ -0,0 +1,232 @@
+// micro-benchmark: every curve x evaluation mode x input distribution.
+// prints one csv row per combination: ns/sample, throughput and per-block
+// latency percentiles. steady-state lut, tuner and parallel modes build their
+// tables and threads on the untimed warm-up block; parallel splits each block
+// into 4 chunks, so its latency includes the dispatch.
+// usage: bench.out [samples-per-run] [type-or-name...]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "tween.hpp"
+
+namespace {
+
+    typedef std::chrono::steady_clock clock_type;
+
+    enum { BLOCK = 1024 };
+
+    volatile double sink;
+
+    double elapsed_ns( clock_type::time_point a, clock_type::time_point b ) {
+        return std::chrono::duration<double, std::nano>( b - a ).count();
+    }
+
+    // inputs in [0,1]
+    std::vector<float> distribution( const std::string &name, size_t n ) {
+        std::vector<float> t( n );
+        std::mt19937 rng( 1234 );
+        std::uniform_real_distribution<float> u( 0.f, 1.f );
+        if( name == "uniform" ) {
+            for( size_t i = 0; i < n; ++i ) t[i] = float( double(i) / (n - 1) );
+        }
+        else if( name == "random" ) {
+            for( size_t i = 0; i < n; ++i ) t[i] = u( rng );
+        }
+        else if( name == "sorted" ) {
+            for( size_t i = 0; i < n; ++i ) t[i] = u( rng );
+            std::sort( t.begin(), t.end() );
+        }
+        else /* frame: BLOCK tweens of random phase/duration, advanced one 60hz frame per block */ {
+            std::vector<float> phase( BLOCK ), step( BLOCK );
+            for( size_t j = 0; j < BLOCK; ++j ) phase[j] = u( rng ), step[j] = (1 / 60.f) / (0.25f + 2 * u( rng ));
+            for( size_t i = 0; i < n; ++i ) {
+                size_t j = i % BLOCK;
+                t[i] = phase[j];
+                phase[j] = phase[j] + step[j] >= 1 ? 0 : phase[j] + step[j];
+            }
+        }
+        return t;
+    }
+
+    // steady-state tables, built on a mode's untimed warm-up block
+    const tween::lut &table( int type, int lookup ) {
+        static tween::lut luts[2][tween::TOTAL];
+        static bool built[2][tween::TOTAL];
+        int m = lookup == tween::LUT_HERMITE;
+        if( !built[m][type] ) luts[m][type] = tween::lut( type, 256, lookup ), built[m][type] = true;
+        return luts[m][type];
+    }
+    const tween::tuner &tuned() {
+        static tween::tuner t;
+        return t;
+    }
+    tween::parallel &workers() {
+        static tween::parallel p( std::thread::hardware_concurrency(), BLOCK / 4 );
+        return p;
+    }
+
+    struct mode {
+        const char *name;
+        std::function<double( int type, const std::vector<float> &t, size_t lo, size_t hi )> run;
+    };
+
+    std::vector<mode> modes() {
+        std::vector<mode> m;
+        m.push_back( mode { "exact", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += tween::ease( type, double( t[i] ) );
+            return s;
+        } } );
+        m.push_back( mode { "exact_float", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += tween::ease<float>( type, t[i] );
+            return s;
+        } } );
+        m.push_back( mode { "memoized", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += tween::ease( type, double( t[i] ), true );
+            return s;
+        } } );
+        m.push_back( mode { "fast", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += tween::ease_fast( type, t[i] );
+            return s;
+        } } );
+        m.push_back( mode { "q15", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += tween::ease_q15( type, (unsigned short)( t[i] * 65535 ) );
+            return s;
+        } } );
+        m.push_back( mode { "lut_linear", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            const tween::lut &l = table( type, tween::LUT_LINEAR );
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += l( t[i] );
+            return s;
+        } } );
+        m.push_back( mode { "lut_hermite", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            const tween::lut &l = table( type, tween::LUT_HERMITE );
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += l( t[i] );
+            return s;
+        } } );
+        m.push_back( mode { "tuner", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            const tween::tuner &tu = tuned();
+            double s = 0;
+            for( size_t i = lo; i < hi; ++i ) s += tu( type, t[i] );
+            return s;
+        } } );
+        m.push_back( mode { "batch", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            float out[BLOCK];
+            tween::ease( type, &t[lo], out, hi - lo );
+            return double( out[0] );
+        } } );
+        m.push_back( mode { "batch_double", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            double in[BLOCK], out[BLOCK];
+            for( size_t i = lo; i < hi; ++i ) in[i - lo] = t[i];
+            tween::ease( type, in, out, hi - lo );
+            return out[0];
+        } } );
+        m.push_back( mode { "batch_fast", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            float out[BLOCK];
+            tween::ease_fast( type, &t[lo], out, hi - lo );
+            return double( out[0] );
+        } } );
+        m.push_back( mode { "parallel", []( int type, const std::vector<float> &t, size_t lo, size_t hi ) {
+            float out[BLOCK];
+            workers().ease( type, &t[lo], out, hi - lo );
+            return double( out[0] );
+        } } );
+        return m;
+    }
+
+    double percentile( std::vector<double> &v, double p ) {
+        size_t k = size_t( p * (v.size() - 1) + 0.5 );
+        std::nth_element( v.begin(), v.begin() + k, v.end() );
+        return v[k];
+    }
+
+    int parse_type( const char *arg ) {
+        char *end;
+        long t = std::strtol( arg, &end, 0 );
+        if( *end == 0 ) return int( t );
+        for( int i = 0; i < tween::TOTAL; ++i ) {
+            if( !strcmp( tween::nameof( i ), arg ) ) return i;
+        }
+        return -1;
+    }
+}
+
+int main( int argc, const char **argv ) {
+    size_t samples = 1 << 18;
+    std::vector<int> types;
+    for( int i = 1; i < argc; ++i ) {
+        if( i == 1 && std::strtol( argv[i], 0, 0 ) >= BLOCK ) {
+            samples = std::strtoul( argv[i], 0, 0 );
+            continue;
+        }
+        int t = parse_type( argv[i] );
+        if( t < 0 || t >= tween::TOTAL ) {
+            std::fprintf( stderr, "unknown type '%s'\n", argv[i] );
+            return 1;
+        }
+        types.push_back( t );
+    }
+    if( types.empty() ) {
+#   define $tween( unused, type ) if( tween::TYPE::type != tween::UNDEFINED ) types.push_back( tween::TYPE::type );
+        $tween_xmacro(expand types)
+#   undef $tween
+        std::sort( types.begin(), types.end() );
+    }
+    samples = (samples + BLOCK - 1) / BLOCK * BLOCK;
+
+    const char *dists[] = { "uniform", "sorted", "random", "frame" };
+    std::vector<mode> ms = modes();
+
+    std::printf( "type,mode,distribution,samples,ns_per_sample,msamples_per_s,p50_ns,p90_ns,p99_ns\n" );
+
+    // cold start: first memoized call per curve builds its table; lut/q15 tables by construction
+    for( int type : types ) {
+        clock_type::time_point a = clock_type::now();
+        sink = tween::ease( type, 0.5, true );
+        clock_type::time_point b = clock_type::now();
+        sink = tween::ease_q15( type, 32768 );
+        clock_type::time_point c = clock_type::now();
+        tween::lut table( type, 256, tween::LUT_HERMITE );
+        clock_type::time_point d = clock_type::now();
+        sink = table( 0.5 );
+        std::printf( "%s,cold_memoized,-,1,%.1f,,,,\n", tween::nameof( type ), elapsed_ns( a, b ) );
+        std::printf( "%s,cold_q15,-,1,%.1f,,,,\n", tween::nameof( type ), elapsed_ns( b, c ) );
+        std::printf( "%s,cold_lut_hermite,-,1,%.1f,,,,\n", tween::nameof( type ), elapsed_ns( c, d ) );
+    }
+
+    for( const char *dist : dists ) {
+        std::vector<float> t = distribution( dist, samples );
+        for( int type : types ) {
+            for( const mode &m : ms ) {
+                m.run( type, t, 0, BLOCK ); // warm up
+                std::vector<double> block;
+                block.reserve( samples / BLOCK );
+                double acc = 0;
+                clock_type::time_point start = clock_type::now();
+                for( size_t lo = 0; lo < samples; lo += BLOCK ) {
+                    clock_type::time_point a = clock_type::now();
+                    acc += m.run( type, t, lo, lo + BLOCK );
+                    block.push_back( elapsed_ns( a, clock_type::now() ) / double(BLOCK) );
+                }
+                double total = elapsed_ns( start, clock_type::now() );
+                sink = acc;
+                std::printf( "%s,%s,%s,%zu,%.3f,%.1f,%.3f,%.3f,%.3f\n", tween::nameof( type ), m.name, dist, samples,
+                    total / samples, samples * 1e3 / total,
+                    percentile( block, 0.5 ), percentile( block, 0.9 ), percentile( block, 0.99 ) );
+            }
+        }
+    }
+}
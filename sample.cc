@@ -1,3 +1,4 @@
+#include <chrono>
 #include <cmath>
 #include <limits>
 #include <map>
@@ -10,6 +11,7 @@
 std::string report( const std::vector<int> &easings, int W = 80, int H = 20, bool use_blur = true );
 
 #include <iostream>
+#define TWEEN_STATS 1
 #include "tween.hpp"
 
 int main( int argc, const char **argv ) {
@@ -60,6 +62,9 @@ std::string report( const std::vector<int> &easings, int W, int H, bool use_blur
 
     // draw map (downscaled)
 
+    tween::stats before = tween::stats_snapshot();
+    auto start = std::chrono::steady_clock::now();
+
     for( int x = 0; x < W; ++x )
     {
         // get Y
@@ -78,6 +83,12 @@ std::string report( const std::vector<int> &easings, int W, int H, bool use_blur
         l[ int(y) ][ x ] = filler;
     }
 
+    {
+        tween::stats calls = tween::stats_snapshot() - before;
+        hits = double( calls.total( tween::stats::EXACT ) + calls.total( tween::stats::MEMOIZED ) );
+        lapse = std::chrono::duration<float>( std::chrono::steady_clock::now() - start ).count();
+    }
+
     // blur map
 
     if( use_blur )
@@ -0,0 +1,771 @@
+// unit tests. build: g++ -std=c++11 -I. test.cc test_tu.cc -o test.out && ./test.out
+// -std=c++14 adds the baked table tests, -std=c++20 the coroutine tests.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+#define TWEEN_STATS 1 /* as in test_tu.cc: both units must agree */
+#include "tween.hpp"
+
+// test_tu.cc
+int register_in_other_unit();
+double ease_in_other_unit( int type, double t );
+tween::stats stats_in_other_unit();
+size_t allocations();
+
+namespace {
+
+    int failures = 0;
+
+#   define CHECK( expr ) do { if( !(expr) ) { std::printf( "%s:%d: CHECK( %s ) failed\n", __FILE__, __LINE__, #expr ); ++failures; } } while( 0 )
+
+    void test_registry_across_units() {
+        int id = register_in_other_unit();
+        CHECK( id > tween::UNDEFINED );
+        CHECK( std::string( tween::nameof( id ) ) == "CUBE" );
+        CHECK( std::fabs( tween::ease( id, 0.5 ) - 0.125 ) < 1e-12 );
+        CHECK( std::fabs( tween::ease( id, 0.5, true ) - 0.125 ) < 1e-2 );
+        int here = tween::register_curve( "SQUARE", []( double t ) { return t * t; } );
+        CHECK( here == id + 1 );
+    }
+
+    void test_runtime_curves_in_fast_paths() {
+        int id = register_in_other_unit();
+        CHECK( std::fabs( tween::ease_fast( id, 0.5f ) - 0.125f ) < 1e-6f );
+        float t[3] = { 0.5f, 0.25f, 2.f }, out[3];
+        tween::ease_fast( id, t, out, 3 );
+        CHECK( std::fabs( out[0] - 0.125f ) < 1e-6f && std::fabs( out[2] - 1.f ) < 1e-6f );
+        CHECK( std::abs( tween::ease_q15( id, 32768 ) - 4096 ) <= 1 );
+        unsigned short q[2] = { 32768, 16384 };
+        short qout[2];
+        tween::ease_q15( id, q, qout, 2 );
+        CHECK( std::abs( qout[0] - 4096 ) <= 1 && std::abs( qout[1] - 512 ) <= 1 );
+
+        std::vector<float> in( 10000, 0.5f ), res( 10000 );
+        std::vector<int> types( 10000 );
+        for( size_t i = 0; i < types.size(); ++i ) types[i] = i % 3 ? int(tween::QUADIN) : id;
+        tween::parallel pool( 2, 1024 );
+        pool.ease( types.data(), in.data(), res.data(), in.size() );
+        CHECK( std::fabs( res[0] - 0.125f ) < 1e-6f && std::fabs( res[1] - 0.25f ) < 1e-6f && std::fabs( res[9999] - 0.125f ) < 1e-6f );
+
+        tween::track tracks[2];
+        tracks[0].add( 0, 0, id ), tracks[0].add( 1, 8 );
+        tracks[1].add( 0, 0, tween::QUADIN ), tracks[1].add( 1, 8 );
+        float sampled[2];
+        tween::track::sample( tracks, 2, 0.5f, sampled );
+        CHECK( std::fabs( sampled[0] - 1.f ) < 1e-5f && std::fabs( sampled[1] - 2.f ) < 1e-5f );
+    }
+
+    void test_inverse() {
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            if( !tween::invertible( type ) ) continue;
+            double t = -1;
+            CHECK( tween::ease_inverse( type, -0.5, t ) && t == 0 );
+            CHECK( tween::ease_inverse( type, 1.5, t ) && t == 1 );
+            CHECK( tween::ease_inverse( type, 0.3, t ) && std::fabs( tween::ease( type, t ) - 0.3 ) < 1e-9 );
+            CHECK( !tween::ease_inverse( type, NAN, t ) );
+        }
+        CHECK( !tween::invertible( -1 ) && !tween::invertible( 1000 ) );
+        CHECK( !tween::invertible( register_in_other_unit() ) );
+    }
+
+    void test_bank_install_twice() {
+        const char *path = "test_bank.tmp";
+        CHECK( tween::bank_builder( 64 ).add( tween::QUADIN ).add( "BANKED", []( double t ) { return t * t * t * t; } ).save( path ) );
+        tween::bank a( path ), b( path );
+        std::remove( path );
+        CHECK( a.ok() && b.ok() );
+        CHECK( a.install() == 2 );
+        int custom = a.id( 1 );
+        CHECK( custom > tween::UNDEFINED && std::string( tween::nameof( custom ) ) == "BANKED" );
+        CHECK( a.install() == 2 && a.id( 1 ) == custom );
+        CHECK( b.install() == 2 && b.id( 1 ) == custom && b.id( 0 ) == tween::QUADIN );
+        // no runtime id was spent by the repeated installs
+        int next = tween::register_curve( "NEXT", []( double t ) { return t; } );
+        CHECK( next == custom + 1 );
+        CHECK( std::fabs( tween::ease( custom, 0.5, true ) - 0.0625 ) < 1e-2 );
+    }
+
+    void test_pool_stale_ids() {
+        tween::pool p;
+        unsigned a = p.add( tween::LINEAR, 0, 100, 1 ), b = p.add( tween::LINEAR, 0, 200, 1 );
+        CHECK( p.remove( a ) );
+        CHECK( !p.remove( a ) );
+        unsigned c = p.add( tween::LINEAR, 500, 500, 1 );
+        CHECK( c != a && !p.live( a ) && p.live( c ) );
+        CHECK( !p.remove( a ) );
+        CHECK( p.size() == 2 && p.value( c ) == 500 && p.value( a ) == 0 );
+        CHECK( p.remove( b ) && p.value( c ) == 500 );
+        CHECK( !p.remove( 12345 ) && p.value( 12345 ) == 0 );
+        CHECK( !p.live( ~0u ) && !p.remove( ~0u ) );
+        CHECK( p.size( tween::LINEAR ) == 1 && p.values( tween::LINEAR )[0] == 500 && p.ids( tween::LINEAR )[0] == c );
+        CHECK( p.size( -1 ) == 0 && p.size( tween::TOTAL ) == 0 && !p.values( tween::TOTAL ) && !p.ids( 1 << 30 ) );
+    }
+
+    void test_scheduler_cancel_churn() {
+        tween::scheduler s;
+        std::vector<unsigned> kept;
+        for( int i = 0; i < 100000; ++i ) {
+            unsigned id = s.add( tween::LINEAR, 0, 1, 1e9 + i, 1 );
+            if( i % 1000 ) s.cancel( id ); else kept.push_back( id );
+        }
+        CHECK( s.pending() == kept.size() );
+        CHECK( s.value( 999999 ) == 0 && !s.cancel( 999999 ) );
+        CHECK( s.size( -1 ) == 0 && !s.values( tween::TOTAL ) && !s.ids( tween::TOTAL ) );
+        s.tick( 2e9 );
+        CHECK( s.started().size() == kept.size() && s.completed().size() == kept.size() && s.pending() == 0 );
+        for( size_t i = 0; i < kept.size() && i < s.started().size(); ++i ) {
+            CHECK( s.started()[i].id == kept[i] );
+        }
+    }
+
+    void test_stats_across_units() {
+        tween::stats before = tween::stats_snapshot(), other = stats_in_other_unit();
+        for( int i = 0; i < 10; ++i ) tween::ease( tween::QUADIN, i / 10.0 );
+        ease_in_other_unit( tween::QUADIN, 0.5 );
+        tween::stats delta = tween::stats_snapshot() - before;
+        CHECK( delta( tween::QUADIN, tween::stats::EXACT ) == 11 );
+        CHECK( (stats_in_other_unit() - other)( tween::QUADIN, tween::stats::EXACT ) == 11 );
+        CHECK( (tween::stats_thread() - before)( tween::QUADIN, tween::stats::EXACT ) == 11 );
+    }
+
+    void test_scheduler_stale_ids() {
+        tween::scheduler s;
+        unsigned a = s.add( tween::LINEAR, 0, 1, 0, 1 );
+        s.tick( 2 );
+        CHECK( s.completed().size() == 1 && s.completed()[0].id == a );
+        unsigned b = s.add( tween::LINEAR, 5, 6, 10, 1 );
+        CHECK( b != a && tween::scheduler::index( b ) == tween::scheduler::index( a ) );
+        CHECK( !s.cancel( a ) && !s.active( a ) && s.value( a ) == 0 );
+        CHECK( s.value( b ) == 5 && s.pending() == 1 );
+        s.tick( 10.5 );
+        CHECK( s.started().size() == 1 && s.started()[0].id == b && s.active( b ) && !s.active( a ) );
+        CHECK( std::fabs( s.value( b ) - 5.5f ) < 1e-6f );
+        CHECK( s.cancel( b ) && !s.cancel( b ) );
+    }
+
+    // documented bounds of ease_fast() against ease()
+    double fast_bound( int type ) {
+        switch( type ) {
+            case tween::SINEIN: case tween::SINEOUT: case tween::SINEINOUT: case tween::SINPI2: case tween::SWING: return 7e-7;
+            case tween::EXPOIN: case tween::EXPOOUT: case tween::EXPOINOUT:
+            case tween::ELASTICIN: case tween::ELASTICOUT: case tween::ELASTICINOUT: return 3.3e-6;
+            case tween::SINESQUARE: return 1.4e-6;
+            case tween::EXPONENTIAL: return 1e-6;
+            default: return 3.1e-6;
+        }
+    }
+
+    void test_fast_math_bounds() {
+        std::vector<float> t( 65537 ), out( t.size() );
+        for( size_t i = 0; i < t.size(); ++i ) t[i] = float( i / 65536.0 );
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            if( type == tween::UNDEFINED ) continue;
+            tween::ease_fast( type, t.data(), out.data(), t.size() );
+            double scalar = 0, batch = 0;
+            for( size_t i = 0; i < t.size(); ++i ) {
+                double ref = tween::ease( type, double( t[i] ) );
+                scalar = std::max( scalar, std::fabs( tween::ease_fast( type, t[i] ) - ref ) );
+                batch = std::max( batch, std::fabs( out[i] - ref ) );
+            }
+            CHECK( scalar <= fast_bound( type ) );
+            CHECK( batch <= fast_bound( type ) );
+            CHECK( tween::ease_fast_error( type ) <= fast_bound( type ) && tween::ease_fast_error( type ) == scalar );
+        }
+    }
+
+    // batch vs scalar ease<T>. the lengths and offsets walk the avx2, sse2 and scalar tail paths
+    void test_batch_matches_scalar() {
+        const size_t n = 1027;
+        std::vector<float> tf( n ), of( n );
+        std::vector<double> td( n ), od( n );
+        for( size_t i = 0; i < n; ++i ) td[i] = -0.25 + 1.5 * i / (n - 1), tf[i] = float( td[i] );
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            for( size_t off = 0; off < 3; ++off ) {
+                for( size_t len = 0; len <= 19; ++len ) {
+                    size_t count = len == 19 ? n - off : len;
+                    tween::ease( type, &tf[off], &of[off], count );
+                    tween::ease( type, &td[off], &od[off], count );
+                    double ef = 0, ed = 0;
+                    for( size_t i = off; i < off + count; ++i ) {
+                        ef = std::max( ef, std::fabs( double( of[i] - tween::ease<float>( type, tf[i] ) ) ) );
+                        ed = std::max( ed, std::fabs( od[i] - tween::ease( type, td[i] ) ) );
+                    }
+                    // either side may contract to fma: a few float ulps, more where the
+                    // BOUNCE* quadratics cancel (~10.8 p^2 - 20.5 p + 10.7 near 1)
+                    bool bounce = type >= tween::BOUNCEIN && type <= tween::BOUNCEINOUT;
+                    CHECK( ef < (bounce ? 2e-6 : 4e-7) );
+                    CHECK( ed < 1e-12 );
+                }
+            }
+        }
+    }
+
+#   if tween$cxx14
+    // the baked rows hold what the lazy memo tables would: float( ease( type, i/255 ) )
+    void test_baked_matches_memo() {
+        typedef tween::baked<256> rom;
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            int mismatches = 0;
+            for( int i = 0; i < 256; ++i ) {
+                mismatches += rom::rows[type][i] != float( tween::ease( type, i / 255.0 ) );
+                CHECK( std::fabs( tween::baked<256, double>::rows[type][i] - tween::ease( type, i / 255.0 ) ) < 1e-12 );
+            }
+            CHECK( mismatches == 0 );
+            CHECK( rom::ease( type, 0.3 ) == rom::rows[type][int(0.3 * 255)] );
+            CHECK( rom::ease( type, -1 ) == rom::rows[type][0] && rom::ease( type, 2 ) == rom::rows[type][255] );
+        }
+        CHECK( rom::ease( tween::TOTAL + 7, 0.5 ) == rom::rows[tween::LINEAR][127] );
+    }
+#   endif
+
+    // max_error() must bound the error seen by a much denser sweep
+    template<typename S>
+    void check_lut_bound( int type, unsigned slots, int mode ) {
+        tween::basic_lut<S> table( type, slots, mode );
+        const unsigned samples = (slots - 1) * 64;
+        double e = 0;
+        for( unsigned i = 0; i <= samples; ++i ) {
+            double t = double(i) / samples;
+            e = std::max( e, std::fabs( table( t ) - tween::ease( type, t ) ) );
+        }
+        CHECK( e <= table.max_error() * (1 + 1e-9) );
+    }
+
+    void test_lut_error_bounds() {
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            for( int mode = tween::LUT_NEAREST; mode <= tween::LUT_HERMITE; ++mode ) {
+                check_lut_bound<float>( type, 16, mode );
+                check_lut_bound<float>( type, 256, mode );
+                check_lut_bound<tween::half>( type, 64, mode );
+            }
+        }
+        tween::lut linear( tween::SINEIN, 256, tween::LUT_LINEAR ), hermite( tween::SINEIN, 256, tween::LUT_HERMITE );
+        CHECK( hermite.max_error() < linear.max_error() && linear.max_error() < 1e-5 );
+        CHECK( linear.bytes() == 256 * sizeof(float) && hermite.bytes() == 2 * 256 * sizeof(float) );
+        CHECK( tween::basic_lut<tween::half>( tween::SINEIN, 256 ).bytes() == 256 * 2 );
+        CHECK( tween::lut( tween::LINEAR, 2 ).max_error() < 1e-7 );
+    }
+
+    // easer<TYPE> for every TYPE, by recursion: exact and fast forms vs the dynamic dispatch
+    template<int TYPE>
+    void check_easers() {
+        for( int i = -2; i <= 66; ++i ) {
+            double t = i / 64.0;
+            CHECK( std::fabs( tween::easer<TYPE>()( t ) - tween::ease( TYPE, t ) ) < 1e-12 );
+            CHECK( std::fabs( tween::easer<TYPE, tween::fast_math>()( t ) - tween::ease_fast( TYPE, float(t) ) ) < 1e-6 );
+        }
+        check_easers<TYPE + 1>();
+    }
+    template<>
+    void check_easers<tween::TOTAL>() {}
+
+    void test_static_dispatch() {
+        check_easers<0>();
+        typedef tween::easer<tween::QUADIN> quadin;
+        for( int i = 0; i <= 64; ++i ) {
+            double t = i / 64.0;
+            CHECK( std::fabs( tween::easer_out<quadin>()( t ) - tween::quadout( t ) ) < 1e-12 );
+            CHECK( std::fabs( tween::easer_inout<quadin>()( t ) - tween::quadinout( t ) ) < 1e-12 );
+            CHECK( std::fabs( tween::easer_chain<tween::easer<tween::BOUNCEIN>, quadin>()( t ) - tween::bouncein( tween::quadin( t ) ) ) < 1e-12 );
+            CHECK( std::fabs( tween::easer_product<tween::easer<tween::BOUNCEIN>, quadin>()( t ) - tween::bouncein( t ) * tween::quadin( t ) ) < 1e-12 );
+            CHECK( std::fabs( tween::easer_pingpong<quadin>()( t ) - tween::quadin( tween::pingpong( t ) ) ) < 1e-12 );
+        }
+    }
+
+    void test_track_segments() {
+        tween::track empty, one;
+        one.add( 2, 7 );
+        CHECK( empty.sample( 1 ) == 0 && one.sample( 0 ) == 7 && one.sample( 5 ) == 7 );
+
+        tween::track k;  // keys out of order: add() keeps them sorted
+        k.add( 3, 30 ), k.add( 0, 0, tween::QUADIN ), k.add( 1, 10, tween::LINEAR );
+        CHECK( k.size() == 3 && k.duration() == 3 );
+        CHECK( k.sample( -1 ) == 0 && k.sample( 4 ) == 30 );
+        CHECK( std::fabs( k.sample( 0.5f ) - 2.5f ) < 1e-5f );  // first segment eased by QUADIN
+        CHECK( std::fabs( k.sample( 1 ) - 10 ) < 1e-5f && std::fabs( k.sample( 2 ) - 20 ) < 1e-5f );
+        CHECK( std::fabs( k.sample( 0.25f ) - 0.625f ) < 1e-5f );  // seek back past the cursor
+
+        // batch sampling buckets by curve; it must agree with sample( time ) per track
+        int custom = register_in_other_unit();
+        std::vector<tween::track> tracks( 64 ), copies;
+        for( size_t i = 0; i < tracks.size(); ++i ) {
+            for( int j = 0; j < 4; ++j ) {
+                int type = i % 9 == 8 ? custom : int( (i * 7 + j) % tween::TOTAL );
+                tracks[i].add( float( j + (i % 3) * 0.5 ), float( (i * 13 + j * 5) % 11 ), type );
+            }
+        }
+        copies = tracks;
+        tween::track::scratch scratch;
+        std::vector<float> out( tracks.size() );
+        for( float time = -0.5f; time < 5; time += 0.375f ) {
+            tween::track::sample( tracks.data(), tracks.size(), time, out.data(), scratch );
+            for( size_t i = 0; i < tracks.size(); ++i ) {
+                CHECK( std::fabs( out[i] - copies[i].sample( time ) ) < 5e-5f );  // float batch lanes vs double: BOUNCE* 3e-6 * 10
+            }
+        }
+    }
+
+    float dot4( const float *a, const float *b ) {
+        return a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3];
+    }
+
+    void test_lerp_slerp() {
+        const float a[7] = { 0, 1, 2, 3, 4, 5, 6 }, b[7] = { 10, -1, 2, 7, 0, 5.5f, -6 };
+        float out[7];
+        tween::lerp<7>( tween::QUADIN, 0, a, b, out );
+        CHECK( std::equal( out, out + 7, a ) );
+        tween::lerp<7>( tween::QUADIN, 1, a, b, out );
+        CHECK( std::equal( out, out + 7, b ) );
+        tween::lerp<7>( tween::QUADIN, 0.5, a, b, out );
+        for( int i = 0; i < 7; ++i ) CHECK( std::fabs( out[i] - (a[i] + (b[i] - a[i]) * 0.25f) ) < 1e-6f );
+
+        // batch: count samples of N floats each, same as the scalar form
+        float t[3] = { 0.25f, 0.5f, 1.5f }, as[21], bs[21], batch[21], one[7];
+        for( int i = 0; i < 21; ++i ) as[i] = a[i % 7] + i, bs[i] = b[i % 7] - i;
+        tween::lerp<7>( tween::CUBICOUT, t, as, bs, batch, 3 );
+        for( int s = 0; s < 3; ++s ) {
+            tween::lerp<7>( tween::CUBICOUT, t[s], as + s * 7, bs + s * 7, one );
+            for( int i = 0; i < 7; ++i ) CHECK( std::fabs( batch[s * 7 + i] - one[i] ) < 1e-5f );
+        }
+
+        // quaternions: endpoints, unit norm, constant angular speed for LINEAR
+        const float h = std::sqrt( 0.5f ), qa[4] = { 0, 0, 0, 1 }, qb[4] = { 0, 0, h, h }, qn[4] = { 0, 0, -h, -h };
+        float q[4];
+        tween::slerp( tween::LINEAR, 0, qa, qb, q );
+        CHECK( std::fabs( dot4( q, qa ) - 1 ) < 1e-6f );
+        tween::slerp( tween::LINEAR, 1, qa, qb, q );
+        CHECK( std::fabs( dot4( q, qb ) - 1 ) < 1e-6f );
+        for( int i = 0; i <= 16; ++i ) {
+            tween::slerp( tween::LINEAR, i / 16.0, qa, qb, q );
+            CHECK( std::fabs( dot4( q, q ) - 1 ) < 1e-5f );
+            CHECK( std::fabs( std::acos( std::min( 1.f, dot4( q, qa ) ) ) - std::acos( h ) * i / 16 ) < 1e-3f );
+            tween::slerp( tween::ELASTICOUT, i / 16.0, qa, qb, q );
+            CHECK( std::fabs( dot4( q, q ) - 1 ) < 1e-5f );
+            tween::nlerp( tween::SINEINOUT, i / 16.0, qa, qn, q );  // shortest arc: qn is qb negated
+            CHECK( std::fabs( dot4( q, q ) - 1 ) < 1e-5f && dot4( q, qa ) > h - 1e-5f );
+        }
+        tween::slerp( tween::LINEAR, 1, qa, qn, q );
+        CHECK( std::fabs( std::fabs( dot4( q, qb ) ) - 1 ) < 1e-6f );
+        tween::slerp( tween::LINEAR, 0.5, qa, qa, q );  // parallel: the nlerp branch
+        CHECK( std::fabs( dot4( q, qa ) - 1 ) < 1e-6f );
+
+        float ts[2] = { 0.3f, 0.8f }, qas[8], qbs[8], qs[8];
+        std::copy( qa, qa + 4, qas ), std::copy( qa, qa + 4, qas + 4 );
+        std::copy( qb, qb + 4, qbs ), std::copy( qn, qn + 4, qbs + 4 );
+        tween::slerp( tween::QUADINOUT, ts, qas, qbs, qs, 2 );
+        for( int s = 0; s < 2; ++s ) {
+            tween::slerp( tween::QUADINOUT, ts[s], qas + s * 4, qbs + s * 4, q );
+            CHECK( std::fabs( dot4( q, qs + s * 4 ) - 1 ) < 1e-5f );
+        }
+    }
+
+    // documented q15 error, in LSBs
+    double q15_bound( int type ) {
+        switch( type ) {
+            default: return 2;
+            case tween::ELASTICIN: case tween::ELASTICOUT: case tween::ELASTICINOUT: return 4;
+            case tween::EXPOIN: case tween::EXPOOUT: case tween::EXPOINOUT: return 32;
+            case tween::BOUNCEIN: case tween::BOUNCEOUT: case tween::BOUNCEINOUT: return 65;
+            case tween::CIRCIN: case tween::CIRCOUT: case tween::CIRCINOUT: return 363;
+        }
+    }
+
+    // every Q16 input, and short runs for the avx2 16 lane and scalar tails
+    void test_q15_batch_matches_scalar() {
+        std::vector<unsigned short> t( 65536 );
+        std::vector<short> out( 65536 );
+        for( unsigned i = 0; i < 65536; ++i ) t[i] = (unsigned short)( i * 40503u );  // every value, scrambled
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            tween::ease_q15( type, t.data(), out.data(), t.size() );
+            int mismatches = 0;
+            for( unsigned i = 0; i < 65536; ++i ) mismatches += out[i] != tween::ease_q15( type, t[i] );
+            for( size_t len = 1; len <= 33; ++len ) {
+                tween::ease_q15( type, &t[len], &out[len], len );
+                for( size_t i = len; i < len + len; ++i ) mismatches += out[i] != tween::ease_q15( type, t[i] );
+            }
+            CHECK( mismatches == 0 );
+            CHECK( tween::ease_q15_error( type ) <= q15_bound( type ) );
+        }
+        CHECK( tween::ease_q15( tween::LINEAR, 0 ) == 0 && tween::ease_q15( tween::LINEAR, 32768 ) == 16384 );
+        CHECK( tween::ease_q15( tween::BACKOUT, 45000 ) == 32767 );  // overshoot saturates
+    }
+
+    void test_precisions() {
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            double ef = 0, el = 0;
+            for( int i = 0; i <= 4096; ++i ) {
+                double t = i / 4096.0, d = tween::ease( type, t );
+                ef = std::max( ef, std::fabs( tween::ease<float>( type, float(t) ) - d ) );
+                el = std::max( el, double( std::fabs( tween::ease<long double>( type, t ) - d ) ) );
+            }
+            CHECK( ef <= 3e-6 );  // documented: within 3e-6 of double, worst on BOUNCE*
+            CHECK( el <= 1e-12 );
+            CHECK( tween::ease<double>( type, 0.3 ) == tween::ease( type, 0.3 ) );
+        }
+        // half: binary16 storage. exact on small dyadics, 11 significant bits otherwise
+        CHECK( float( tween::half( 0.5 ) ) == 0.5f && float( tween::half( -0.75 ) ) == -0.75f && float( tween::half( 0 ) ) == 0 );
+        for( int i = 1; i <= 1000; ++i ) {
+            double v = i / 997.0;
+            CHECK( std::fabs( float( tween::half( v ) ) - v ) <= v / 2048 );
+        }
+        CHECK( float( tween::half( 1e-6 ) ) > 0 && std::fabs( float( tween::half( 1e-6 ) ) - 1e-6 ) < 6e-8 );  // subnormal
+        CHECK( std::isinf( float( tween::half( 1e6 ) ) ) && std::isnan( float( tween::half( NAN ) ) ) );
+    }
+
+    void test_tuner_save_load() {
+        tween::tuner tuned( 1e-4 ), loaded( 1e-4, false );
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            bool is_lut = tuned.strategy( type ) == tween::EVAL_LUT_LINEAR || tuned.strategy( type ) == tween::EVAL_LUT_HERMITE;
+            CHECK( tuned.error( type ) <= 1e-4 && is_lut == (tuned.slots( type ) > 0) );
+            CHECK( loaded.strategy( type ) == tween::EVAL_EXACT );
+            double e = 0;
+            for( int i = 0; i <= 1000; ++i ) e = std::max( e, std::fabs( tuned( type, i / 1000.0 ) - tween::ease( type, i / 1000.0 ) ) );
+            CHECK( e <= 1e-4 );
+        }
+
+        const std::string config = tuned.save();
+        CHECK( loaded.load( config ) && loaded.save() == config && loaded.tolerance() == 1e-4 );
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            CHECK( loaded.strategy( type ) == tuned.strategy( type ) && loaded.slots( type ) == tuned.slots( type ) );
+            for( int i = 0; i <= 16; ++i ) CHECK( loaded( type, i / 16.0 ) == tuned( type, i / 16.0 ) );
+        }
+
+        // rejected configs leave the tuner as it was
+        std::string wrong_version = config, unknown = config, truncated = config.substr( 0, config.size() / 2 );
+        wrong_version.replace( wrong_version.find( " 1 " ), 3, " 2 " );
+        unknown.replace( unknown.find( "\nQUADIN " ) + 8, 0, "bogus_" );
+        CHECK( !loaded.load( "" ) && !loaded.load( wrong_version ) && !loaded.load( unknown ) && !loaded.load( truncated ) );
+        CHECK( loaded.save() == config );
+
+        int custom = register_in_other_unit();
+        CHECK( loaded( custom, 0.5 ) == tween::ease( custom, 0.5 ) && loaded.strategy( custom ) == tween::EVAL_EXACT );
+    }
+
+    void test_bezier_spline() {
+        tween::bezier linear, css( 0.25, 0.1, 0.25, 1 ), clamped( -1, 0, 2, 1 );
+        float xs[5] = { 0, 0.1f, 0.5f, 0.9f, 1 }, batch[5];
+        css( xs, batch, 5 );
+        for( int i = 0; i < 5; ++i ) CHECK( std::fabs( batch[i] - css( xs[i] ) ) < 1e-6 );
+        for( int i = 0; i <= 200; ++i ) {
+            // walk the curve by its parameter s: solving x(s) must give back y(s)
+            double s = i / 200.0, r = 1 - s;
+            double x = 3 * r * r * s * 0.25 + 3 * r * s * s * 0.25 + s * s * s, y = 3 * r * r * s * 0.1 + 3 * r * s * s + s * s * s;
+            CHECK( std::fabs( css( x ) - y ) < 1e-7 );
+            CHECK( std::fabs( css( x, true ) - y ) < 1e-2 );  // memo: nearest of 256 slots
+            CHECK( std::fabs( linear( s ) - s ) < 1e-9 );
+            double c = clamped( s );  // x1, x2 clamped to [0,1]: still a function of x
+            CHECK( c >= -1e-9 && c <= 1 + 1e-9 );
+        }
+        CHECK( css( -1 ) == 0 && css( 2 ) == 1 );
+
+        const double xy[] = { 0.2, 0.5, 0.6, 0.6, 0.4, 0.55 };  // unsorted; (0,0) and (1,1) get added
+        tween::spline sp( xy, 3 );
+        CHECK( std::fabs( sp( 0.2 ) - 0.5 ) < 1e-9 && std::fabs( sp( 0.4 ) - 0.55 ) < 1e-9 && std::fabs( sp( 0.6 ) - 0.6 ) < 1e-9 );
+        CHECK( std::fabs( sp( 0 ) ) < 1e-9 && std::fabs( sp( 1 ) - 1 ) < 1e-9 );
+        double last = 0;
+        for( int i = 0; i <= 1000; ++i ) {
+            double v = sp( i / 1000.0 );
+            CHECK( v >= last - 1e-12 );  // monotone data: no overshoot
+            last = v;
+        }
+        float out[5];
+        sp( xs, out, 5 );
+        for( int i = 0; i < 5; ++i ) CHECK( std::fabs( out[i] - sp( xs[i] ) ) < 1e-6 );
+    }
+
+    void test_expr() {
+        using tween::expr;
+        const int custom = register_in_other_unit();  // t^3
+        expr sum = expr( tween::QUADIN ) * expr( tween::CUBICOUT ) + expr::constant( 0.25 ) - expr( custom );
+        expr nested = nest( expr( tween::BOUNCEIN ), expr( tween::QUADIN ) );
+        expr outer = out( expr( tween::QUADIN ) ), both = inout( expr( tween::CUBICIN ) );
+        expr bounced = pingpong( expr( tween::QUADIN ) ), back = pong( expr( tween::QUADIN ) ), there = pongping( expr( tween::QUADIN ) );
+        CHECK( sum.max_error() == 0 );
+        for( int i = 0; i <= 64; ++i ) {
+            double t = i / 64.0;
+            CHECK( std::fabs( sum( t ) - (tween::quadin( t ) * tween::cubicout( t ) + 0.25 - t * t * t) ) < 1e-12 );
+            CHECK( std::fabs( nested( t ) - tween::bouncein( tween::quadin( t ) ) ) < 1e-12 );
+            CHECK( std::fabs( outer( t ) - tween::quadout( t ) ) < 1e-12 );
+            CHECK( std::fabs( both( t ) - tween::cubicinout( t ) ) < 1e-12 );
+            CHECK( std::fabs( bounced( t ) - tween::quadin( tween::pingpong( t ) ) ) < 1e-12 );
+            CHECK( std::fabs( back( t ) - tween::quadin( tween::pong( t ) ) ) < 1e-12 );
+            CHECK( std::fabs( there( t ) - tween::quadin( tween::pongping( t ) ) ) < 1e-12 );
+        }
+
+        std::vector<float> t( 1000 ), out( 1000 );
+        for( size_t i = 0; i < t.size(); ++i ) t[i] = float( i ) / 999;
+        sum( t.data(), out.data(), t.size() );
+        for( size_t i = 0; i < t.size(); ++i ) CHECK( std::fabs( out[i] - sum( t[i] ) ) < 1e-5 );
+
+        // bake: one hermite table for the whole program, max_error() bounds it
+        expr baked = sum;
+        baked.bake( 256 );
+        CHECK( baked.max_error() > 0 && baked.max_error() < 1e-4 );
+        double e = 0;
+        for( int i = 0; i <= 255 * 64; ++i ) e = std::max( e, std::fabs( baked( i / (255 * 64.0) ) - sum( i / (255 * 64.0) ) ) );
+        CHECK( e <= baked.max_error() * (1 + 1e-9) );
+        baked( t.data(), out.data(), t.size() );
+        for( size_t i = 0; i < t.size(); ++i ) CHECK( std::fabs( out[i] - baked( t[i] ) ) < 1e-6 );
+        CHECK( in( baked ).max_error() == 0 );  // remapping drops the table
+    }
+
+    // analytic derivatives vs central differences, off the joins and kinks
+    void test_derivatives() {
+        const double h = 1e-5;
+        std::vector<float> t, value( 64 ), velocity( 64 ), acceleration( 64 ), order1( 64 );
+        for( int i = 0; i < 64; ++i ) t.push_back( float( (i + 0.37) / 64 ) );
+        for( int type = 0; type < tween::TOTAL; ++type ) {
+            double scale1 = 1, scale2 = 1;  // float batches: relative to the curve's largest terms
+            for( int i = 0; i < 64; ++i ) {
+                double x = t[i], d1, d2;
+                double v = tween::ease_derivatives( type, x, d1, d2 );
+                scale1 = std::max( scale1, std::fabs( d1 ) ), scale2 = std::max( scale2, std::fabs( d2 ) );
+                double fd1 = (tween::ease( type, x + h ) - tween::ease( type, x - h )) / (2 * h);
+                double fd2 = (tween::ease_derivative( type, x + h ) - tween::ease_derivative( type, x - h )) / (2 * h);
+                CHECK( std::fabs( v - tween::ease( type, x ) ) < 1e-12 && v == tween::ease_derivative( type, x, 0 ) );
+                CHECK( std::fabs( d1 - fd1 ) <= 1e-5 * (1 + std::fabs( d1 )) );
+                CHECK( std::fabs( d2 - fd2 ) <= 1e-5 * (1 + std::fabs( d2 )) );
+                CHECK( d2 == tween::ease_derivative( type, x, 2 ) );
+            }
+            tween::ease_derivatives( type, t.data(), value.data(), velocity.data(), acceleration.data(), t.size() );
+            tween::ease_derivative( type, t.data(), order1.data(), t.size(), 1 );
+            for( int i = 0; i < 64; ++i ) {
+                double d1, d2, v = tween::ease_derivatives( type, t[i], d1, d2 );
+                CHECK( std::fabs( value[i] - v ) <= 1e-5 );
+                CHECK( std::fabs( velocity[i] - d1 ) <= 1e-5 * scale1 );
+                CHECK( std::fabs( acceleration[i] - d2 ) <= 1e-5 * scale2 );
+                CHECK( order1[i] == velocity[i] );
+            }
+            CHECK( tween::ease_derivative( type, -0.5 ) == 0 && tween::ease_derivative( type, 1.5, 2 ) == 0 );
+            float outside[2] = { -0.5f, 1.5f }, zeros[2];
+            tween::ease_derivative( type, outside, zeros, 2, 2 );
+            CHECK( zeros[0] == 0 && zeros[1] == 0 );
+            CHECK( std::isnan( tween::ease_derivative( type, 0.5, 3 ) ) );
+        }
+        int custom = register_in_other_unit();  // t^3: 3t^2, 6t
+        CHECK( std::fabs( tween::ease_derivative( custom, 0.5 ) - 0.75 ) < 1e-6 && std::fabs( tween::ease_derivative( custom, 0.5, 2 ) - 3 ) < 1e-3 );
+    }
+
+    void test_wrap_modes() {
+        using tween::wrap;
+        CHECK( wrap( tween::WRAP_CLAMP, 1.5 ) == 1 && wrap( tween::WRAP_CLAMP, -0.5 ) == 0 && wrap( tween::WRAP_CLAMP, 0.25 ) == 0.25 );
+        CHECK( wrap( tween::WRAP_REPEAT, 1.25 ) == 0.25 && wrap( tween::WRAP_REPEAT, -0.25 ) == 0.75 && wrap( tween::WRAP_REPEAT, 3.0 ) == 0 );
+        CHECK( wrap( tween::WRAP_MIRROR, 1.25 ) == 0.75 && wrap( tween::WRAP_MIRROR, 2.25 ) == 0.25 && wrap( tween::WRAP_MIRROR, -0.25 ) == 0.25 );
+        CHECK( wrap( tween::WRAP_MIRROR, 1.0 ) == 1 && wrap( tween::WRAP_MIRROR, 2.0 ) == 0 );
+        CHECK( wrap( tween::WRAP_PINGPONG, 0.25 ) == 0.5 && wrap( tween::WRAP_PINGPONG, 0.75 ) == 0.5 && wrap( tween::WRAP_PINGPONG, 1.5 ) == 1 );
+        CHECK( wrap( tween::WRAP_HOLD, -0.5 ) == 0 && wrap( tween::WRAP_HOLD, 1.25 ) == 0.25 && wrap( tween::WRAP_HOLD, 0.5 ) == 0.5 );
+        CHECK( wrap( tween::WRAP_REPEAT, 1e6 + 0.25 ) == 0.25 && wrap( tween::WRAP_MIRROR, 1e6 + 1.25 ) == 0.75 );  // O(1) at any t
+        CHECK( wrap( tween::WRAP_REPEAT, 1.25f ) == 0.25f );
+
+        // batch: lanes and tail agree with the scalar form; ease() applies the mode first
+        std::vector<float> t( 37 ), out( 37 ), eased( 37 );
+        for( size_t i = 0; i < t.size(); ++i ) t[i] = -3.1f + 0.23f * i;
+        for( int mode = tween::WRAP_CLAMP; mode <= tween::WRAP_HOLD; ++mode ) {
+            wrap( mode, t.data(), out.data(), t.size() );
+            for( size_t i = 0; i < t.size(); ++i ) CHECK( std::fabs( out[i] - wrap( mode, t[i] ) ) < 1e-6f );
+            for( int type = 0; type < tween::TOTAL; type += 5 ) {
+                tween::ease( type, t.data(), eased.data(), t.size(), mode );
+                for( size_t i = 0; i < t.size(); ++i ) {
+                    float w = wrap( mode, t[i] );
+                    CHECK( std::fabs( eased[i] - tween::ease<float>( type, w ) ) < 2e-6f );
+                    CHECK( tween::ease( type, double(t[i]), false, mode ) == tween::ease( type, wrap( mode, double(t[i]) ) ) );
+                    CHECK( tween::ease( type, double(t[i]), true, mode ) == tween::ease( type, wrap( mode, double(t[i]) ), true ) );
+                }
+            }
+        }
+    }
+
+    std::string slurp( const char *path ) {
+        std::string out;
+        if( FILE *f = std::fopen( path, "rb" ) ) {
+            char buf[4096];
+            for( size_t n; (n = std::fread( buf, 1, sizeof(buf), f )) > 0; ) out.append( buf, n );
+            std::fclose( f );
+        }
+        return out;
+    }
+
+    // every element type: max_error bounds the lookups, install backs memoized ease()
+    void test_bank_save_install() {
+        const char *path = "test_bank_elements.tmp";
+        const int elements[3] = { tween::BANK_FLOAT, tween::BANK_DOUBLE, tween::BANK_HALF };
+        for( int k = 0; k < 3; ++k ) {
+            tween::bank_builder builder( 100, elements[k] );
+            builder.add( tween::ELASTICOUT ).add( tween::BOUNCEIN ).add( "WAVE", []( double t ) { return t * t * (3 - 2 * t); } );
+            CHECK( builder.save( path ) && slurp( path ) == builder.data() );
+            tween::bank b( path );
+            CHECK( b.ok() && b.size() == 3 && b.find( "WAVE" ) == 2 && b.find( "NONE" ) == -1 );
+            CHECK( std::string( b.name( 0 ) ) == "ELASTICOUT" && b.type( 1 ) == tween::BOUNCEIN && b.type( 2 ) == -1 );
+            for( size_t i = 0; i < b.size(); ++i ) {
+                CHECK( b.slots( i ) == 100 && b.element( i ) == elements[k] );
+                double e = 0;
+                for( int j = 0; j <= 99 * 64; ++j ) {
+                    double t = j / (99 * 64.0), exact = i == 2 ? t * t * (3 - 2 * t) : tween::ease( b.type( i ), t );
+                    e = std::max( e, std::fabs( b( i, t ) - exact ) );
+                }
+                CHECK( e <= b.max_error( i ) * (1 + 1e-9) && b.max_error( i ) < 0.2 );
+            }
+        }
+
+        // the last (half) bank goes live: memoized ease() reads the mapping
+        tween::bank b( path );
+        std::remove( path );
+        CHECK( b.install() == 3 && b.id( 0 ) == tween::ELASTICOUT && b.id( 2 ) > tween::UNDEFINED );
+        for( int j = 0; j <= 64; ++j ) {
+            double t = j / 64.0;
+            CHECK( tween::ease( tween::ELASTICOUT, t, true ) == float( b( 0, t ) ) );
+            CHECK( std::fabs( tween::ease( b.id( 2 ), t ) - t * t * (3 - 2 * t) ) < 1e-3 );  // exact: interpolated row
+        }
+        CHECK( std::string( tween::nameof( b.id( 2 ) ) ) == "WAVE" );
+
+        // rejected files
+        tween::bank missing( "does_not_exist.tmp" );
+        CHECK( !missing.ok() && missing.install() == -1 );
+        std::string image = tween::bank_builder().add( tween::QUADIN ).data();
+        for( int damage = 0; damage < 2; ++damage ) {
+            std::string bad = damage ? image.substr( 0, image.size() - 1 ) : "TWEENBNX" + image.substr( 8 );
+            if( FILE *f = std::fopen( path, "wb" ) ) std::fwrite( bad.data(), 1, bad.size(), f ), std::fclose( f );
+            CHECK( !tween::bank( path ).ok() );
+            std::remove( path );
+        }
+    }
+
+    void test_arena_handles() {
+        tween::arena a;
+        tween::arena::handle h = a.create( tween::QUADIN, 0, 10, 2 ), null;
+        CHECK( a.alive( h ) && !a.alive( null ) && !a.cancel( null ) );
+        a.update( 1 );
+        CHECK( std::fabs( a.value( h ) - 2.5f ) < 1e-5f && a.progress( h ) == 0.5f && !a.done( h ) );
+        CHECK( a.retarget( h, 0, 1 ) && a.value( h ) == 2.5f );  // continues from the current value
+        a.update( 0.5f );
+        CHECK( std::fabs( a.value( h ) - 1.875f ) < 1e-5f );
+        a.update( 1 );
+        CHECK( a.done( h ) && a.value( h ) == 0 );
+
+        // stale handles: the freed slot is reused under a new generation
+        CHECK( a.cancel( h ) && !a.cancel( h ) && !a.alive( h ) && a.value( h ) == 0 );
+        tween::arena::handle reused = a.create( tween::CUBICOUT, 1, 2, 1 );
+        CHECK( reused.index == h.index && reused != h );
+        CHECK( !a.alive( h ) && !a.retarget( h, 5, 1 ) && !a.cancel( h ) && a.alive( reused ) && a.value( reused ) == 1 );
+
+        // many curves: segments shift on create and cancel, values follow their handles
+        std::vector<tween::arena::handle> hs;
+        for( int i = 0; i < 300; ++i ) hs.push_back( a.create( i % tween::TOTAL, float( i ), float( i + 1 ), 1 ) );
+        for( int i = 0; i < 300; i += 3 ) CHECK( a.cancel( hs[i] ) );
+        a.update( 2 );
+        // (EXPONENTIAL ends short of 1, so compare against each curve's own endpoint)
+        for( int i = 0; i < 300; ++i ) CHECK( i % 3 ? std::fabs( a.value( hs[i] ) - (i + tween::ease<float>( i % tween::TOTAL, 1 )) ) < 1e-4f : !a.alive( hs[i] ) );
+
+        // steady state: no allocations once reserved
+        tween::arena warm;
+        warm.reserve( 512 );
+        std::vector<tween::arena::handle> live( 512 );
+        for( int i = 0; i < 512; ++i ) live[i] = warm.create( i % tween::TOTAL, 0, 1, 1 );
+        warm.update( 0.1f );
+        size_t before = allocations();
+        for( int frame = 0; frame < 100; ++frame ) {
+            for( int i = frame % 7; i < 512; i += 7 ) {
+                CHECK( warm.cancel( live[i] ) );
+                live[i] = warm.create( (i + frame) % tween::TOTAL, 0, 1, 0.5f );
+            }
+            warm.retarget( live[frame], 2, 1 );
+            warm.update( 0.016f );
+        }
+        CHECK( allocations() == before );
+    }
+
+#   if tween$coroutines
+    int frames = 0;
+    template<typename T>
+    struct counting : std::allocator<T> {
+        template<typename U> struct rebind { typedef counting<U> other; };
+        counting() {}
+        template<typename U> counting( const counting<U> & ) {}
+        T *allocate( size_t n ) { ++frames; return std::allocator<T>::allocate( n ); }
+        void deallocate( T *p, size_t n ) { --frames; std::allocator<T>::deallocate( p, n ); }
+    };
+    typedef tween::basic_script<counting<unsigned char> > counted_script;
+
+    std::vector<int> resumed;
+    counted_script play( tween::director &d, double duration, int tag ) {
+        co_await d.play( tween::LINEAR, 0, 1, duration );
+        resumed.push_back( tag );
+    }
+    counted_script sequence( tween::director &d, float *x ) {
+        float end = co_await d.play( tween::QUADIN, 0, 10, 1, x );
+        resumed.push_back( int( end ) );
+        co_await d.delay( 0.5 );
+        resumed.push_back( 1 );
+        co_await play( d, 1, 2 );
+        resumed.push_back( 3 );
+    }
+
+    void test_coroutines() {
+        tween::director d;
+        resumed.clear();
+        play( d, 3, 20 ).start();
+        play( d, 1, 10 ).start();
+        play( d, 2, 30 ).start();
+        d.tick( 5 ); /* all three end within one tick */
+        CHECK( resumed.size() == 3 && resumed[0] == 10 && resumed[1] == 30 && resumed[2] == 20 );
+        CHECK( frames == 0 );
+
+        tween::director s;
+        float x = -1;
+        resumed.clear();
+        sequence( s, &x ).start();
+        CHECK( x == -1 && frames == 1 );
+        s.tick( 0.5 );
+        CHECK( std::fabs( x - 2.5f ) < 1e-5f && resumed.empty() );
+        s.tick( 1 );
+        CHECK( x == 10 && resumed.size() == 1 && resumed[0] == 10 );
+        s.tick( 1.4 );
+        CHECK( resumed.size() == 1 );
+        s.tick( 1.5 );
+        CHECK( resumed.size() == 2 && frames == 2 ); /* the sub-script has its own frame */
+        s.tick( 2.5 );
+        CHECK( resumed.size() == 4 && resumed[2] == 2 && resumed[3] == 3 );
+        CHECK( frames == 0 && s.timeline().pending() == 0 && s.timeline().active() == 0 );
+    }
+#   endif
+}
+
+int main() {
+    test_stats_across_units(); /* first: before any other evaluation creates the thread's block */
+    test_registry_across_units();
+    test_runtime_curves_in_fast_paths();
+    test_inverse();
+    test_bank_install_twice();
+    test_pool_stale_ids();
+    test_scheduler_cancel_churn();
+    test_scheduler_stale_ids();
+    test_fast_math_bounds();
+    test_batch_matches_scalar();
+#   if tween$cxx14
+    test_baked_matches_memo();
+#   endif
+    test_lut_error_bounds();
+    test_static_dispatch();
+    test_track_segments();
+    test_lerp_slerp();
+    test_q15_batch_matches_scalar();
+    test_precisions();
+    test_tuner_save_load();
+    test_bezier_spline();
+    test_expr();
+    test_derivatives();
+    test_wrap_modes();
+    test_bank_save_install();
+    test_arena_handles();
+#   if tween$coroutines
+    test_coroutines();
+#   endif
+    if( failures ) {
+        std::printf( "%d checks failed\n", failures );
+        return 1;
+    }
+    std::printf( "all tests passed\n" );
+}
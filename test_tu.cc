@@ -0,0 +1,39 @@
+// second translation unit of test.cc: state registered here must be seen there
+
+#define TWEEN_STATS 1
+#include "tween.hpp"
+
+int register_in_other_unit() {
+    return tween::register_curve( "CUBE", []( double t ) { return t * t * t; } );
+}
+
+double ease_in_other_unit( int type, double t ) {
+    return tween::ease( type, t );
+}
+
+tween::stats stats_in_other_unit() {
+    return tween::stats_snapshot();
+}
+
+// counts every allocation, for the steady-state checks; defined here so test.cc never inlines the pair
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<size_t> allocation_count( 0 );
+
+size_t allocations() {
+    return allocation_count;
+}
+
+void *operator new( size_t n ) {
+    ++allocation_count;
+    if( void *p = std::malloc( n ? n : 1 ) ) return p;
+    throw std::bad_alloc();
+}
+void operator delete( void *p ) noexcept {
+    std::free( p );
+}
+void operator delete( void *p, size_t ) noexcept {
+    std::free( p );
+}
@@ -6,7 +6,63 @@
  */
 
 #pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#   define tween$cxx14 1
+#   define tween$constexpr constexpr
+#else
+#   define tween$constexpr
+#   ifdef TWEEN_BAKED_LUT
+#       error "TWEEN_BAKED_LUT requires C++14 (constexpr loops)"
+#   endif
+#endif
+
+#ifndef TWEEN_CURVE_CACHE_BYTES
+#   define TWEEN_CURVE_CACHE_BYTES (1 << 20) /* memo tables of runtime-registered curves */
+#endif
+
+#ifndef TWEEN_STATS_SAMPLING
+#   define TWEEN_STATS_SAMPLING 1024 /* TWEEN_STATS: time one scalar call in this many; 0 = never */
+#endif
+
+#if !defined(TWEEN_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#   define tween$sse2 1
+#   include <emmintrin.h>
+#endif
+#if !defined(TWEEN_NO_SIMD) && defined(__AVX2__)
+#   define tween$avx2 1
+#   include <immintrin.h>
+#endif
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#   if __has_include(<coroutine>)
+#       define tween$coroutines 1
+#       include <coroutine>
+#       include <exception>
+#   endif
+#endif
+#if !defined(TWEEN_NO_MMAP) && (defined(__unix__) || defined(__APPLE__))
+#   define tween$mmap 1
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
 
 namespace tween
 {
@@ -88,10 +144,217 @@ namespace tween
     // template<typename EASE> double out( double dt01, EASE &ease );
     // template<typename EASE> double inout( double dt01, EASE &ease );
 
+    // static dispatch, inlineable functors ; exact
+    // template<int TYPE, typename MATH = exact_math> struct easer { double operator()( double dt01 ) const; };  // MATH: exact_math, fast_math
+    // template<typename EASE> struct easer_in, easer_out, easer_inout, easer_pingpong, easer_pongping;
+    // template<typename OUTER, typename INNER> struct easer_chain;  // outer(inner(t))
+    // template<typename A, typename B> struct easer_product;        // a(t) * b(t)
+
     // generics
-    // double ease( int type, double dt01, bool memoized = false );
+    // double ease( int type, double dt01, bool memoized = false, int wrap = WRAP_CLAMP );
+    // template<typename T> T ease( int type, T dt01, bool memoized = false, int wrap = WRAP_CLAMP );  // float, double, long double
     // const char *nameof( int type );
 
+    // wrap modes ; O(1) and exact at any t, applied before the clamp by ease() scalar, memoized and batch
+    // enum WRAP { WRAP_CLAMP, WRAP_REPEAT, WRAP_MIRROR, WRAP_PINGPONG, WRAP_HOLD };  // hold: repeat once t >= 0
+    // template<typename T> T wrap( int mode, T t );
+    // template<typename T> void wrap( int mode, const T *t, T *out, size_t n );  // float: avx2/sse2 lanes
+
+    // runtime curves ; ids above UNDEFINED, valid in ease() (all modes), ease_fast(), ease_q15(), derivatives, lut, track, parallel and nameof()
+    // pool, scheduler and arena bucket by builtin curve: they run runtime ids as LINEAR
+    // memo tables live in a TWEEN_CURVE_CACHE_BYTES (1 MiB) cache with eviction ; lock-free reads
+    // int register_curve( const char *name, const std::function<double( double )> &fn );
+
+    // inverse easing ; t such that ease(type,t) == value. false for BACK*, ELASTIC*, BOUNCE* and runtime curves
+    // bool invertible( int type );
+    // bool ease_inverse( int type, double value, double &t );
+
+    // half-precision storage for tables ; converts to/from float
+    // struct half { unsigned short bits; half( double ); operator float() const; };
+
+    // compile-time tables, C++14 ; define TWEEN_BAKED_LUT to back ease(,,true) with baked<256,float>
+    // template<unsigned SLOTS = 256, typename T = float> struct baked {
+    //     static const T *const rows[TOTAL];
+    //     static T ease( int type, double dt01 );
+    // };
+
+    // interpolated lookup tables, per curve resolution and measured error bound
+    // enum LOOKUP { LUT_NEAREST, LUT_LINEAR, LUT_HERMITE };
+    // template<typename S = float> class basic_lut {  // S = float, double, half
+    //     basic_lut( int type = LINEAR, unsigned slots = 256, int mode = LUT_LINEAR );
+    //     basic_lut( const std::function<double( double )> &f, unsigned slots = 256, int mode = LUT_LINEAR );
+    //     double operator()( double dt01 ) const;
+    //     double max_error() const;  // max abs error vs ease(type,dt01)
+    //     size_t bytes() const;
+    // };
+    // typedef basic_lut<float> lut;
+
+    // parametric curves ; solved at construction, exact or memoized, scalar or batch
+    // class bezier {  // css cubic-bezier(x1,y1,x2,y2)
+    //     bezier( double x1 = 0, double y1 = 0, double x2 = 1, double y2 = 1 );
+    //     double operator()( double dt01, bool memoized = false ) const;
+    //     void operator()( const float *dt01, float *out, size_t n, bool memoized = false ) const;
+    // };
+    // class spline {  // monotone cubic through interleaved x,y points
+    //     spline( const double *xy = 0, size_t points = 0 );
+    //     double operator()( double dt01, bool memoized = false ) const;
+    //     void operator()( const float *dt01, float *out, size_t n, bool memoized = false ) const;
+    // };
+
+    // batch ; curve is picked once per call, then avx2/sse2 lanes + scalar tail
+    // void ease( int type, const float *dt01, float *out, size_t n, int wrap = WRAP_CLAMP );
+    // void ease( int type, const double *dt01, double *out, size_t n, int wrap = WRAP_CLAMP );
+
+    // fast approximate math (polynomial sin/cos/exp2), float ; max abs error per type measured by ease_fast_error()
+    // float ease_fast( int type, float dt01 );
+    // void ease_fast( int type, const float *dt01, float *out, size_t n );
+    // double ease_fast_error( int type );  // <= 7e-7 SINE*, <= 3.3e-6 EXPO*/ELASTIC*, <= 3.1e-6 others
+
+    // derivatives w.r.t. dt01, analytic (forward mode over the kernels) ; 0 outside [0,1], one-sided at 0, 1 and joins
+    // double ease_derivative( int type, double dt01, int order = 1 );  // 0: value, 1: velocity, 2: acceleration
+    // void ease_derivative( int type, const float *dt01, float *out, size_t n, int order = 1 );
+    // double ease_derivatives( int type, double dt01, double &velocity, double &acceleration );  // returns the value
+    // void ease_derivatives( int type, const float *dt01, float *value, float *velocity, float *acceleration, size_t n );  // null outputs skipped
+
+    // composition ; one fused program per expression, optionally baked into a single table
+    // class expr {
+    //     explicit expr( int type = LINEAR );
+    //     static expr constant( double k );
+    //     expr operator+( const expr &, const expr & ), operator-( ... ), operator*( ... );
+    //     expr &bake( unsigned slots = 256, int mode = LUT_HERMITE );
+    //     double max_error() const;  // of the baked table, vs the program
+    //     double operator()( double dt01 ) const;
+    //     void operator()( const float *dt01, float *out, size_t n ) const;
+    // };
+    // expr nest( const expr &outer, const expr &inner );  // outer(inner(t))
+    // expr in( const expr & ), out( const expr & ), inout( const expr & );
+    // expr ping( const expr & ), pong( const expr & ), pingpong( const expr & ), pongping( const expr & );
+
+    // auto-tuner ; per curve, the fastest strategy within tolerance on this machine
+    // enum STRATEGY { EVAL_EXACT, EVAL_FLOAT, EVAL_MEMOIZED, EVAL_LUT_LINEAR, EVAL_LUT_HERMITE, EVAL_FAST };
+    // class tuner {
+    //     tuner( double tolerance = 1e-4, bool measure = true );  // measure = false: all exact, for load()
+    //     double operator()( int type, double dt01 ) const;
+    //     int strategy( int type ) const;
+    //     unsigned slots( int type ) const;  // lut strategies only
+    //     double error( int type ) const;
+    //     double ns( int type ) const;
+    //     std::string save() const;
+    //     bool load( const std::string &config );
+    // };
+
+    // pool of tweens, structure-of-arrays and bucketed by curve ; batch updated
+    // class pool {
+    //     unsigned add( int type, float start, float end, float duration );  // ~0u when full
+    //     bool remove( unsigned id );  // false for ids not alive
+    //     bool live( unsigned id ) const;
+    //     void update( float dt );
+    //     float value( unsigned id ) const;
+    //     float progress( unsigned id ) const;
+    //     bool done( unsigned id ) const;
+    // };
+
+    // arena of tweens behind generational handles ; dense per-curve segments, O(1) create/cancel/retarget, no allocations after warm-up
+    // class arena {
+    //     struct handle { unsigned index, generation; };  // default: null handle
+    //     void reserve( size_t n );
+    //     handle create( int type, float start, float end, float duration );
+    //     bool cancel( handle h );                          // false for stale handles
+    //     bool retarget( handle h, float end, float duration );  // from the current value
+    //     bool alive( handle h ) const;
+    //     void update( float dt );
+    //     float value( handle h ) const;
+    //     float progress( handle h ) const;
+    //     bool done( handle h ) const;
+    // };
+
+    // scheduler ; waiting tweens in a min-heap on begin time, active ones bucketed by curve. tick cost ~ active tweens
+    // class scheduler {
+    //     struct event { unsigned id; double time; };  // scheduled begin or end
+    //     unsigned add( int type, float start, float end, double begin, double duration );  // begin: absolute time ; ~0u when full
+    //     bool cancel( unsigned id );                   // false for stale ids
+    //     void tick( double now );
+    //     const std::vector<event> &started() const;    // last tick's events
+    //     const std::vector<event> &completed() const;
+    //     size_t pending() const;
+    //     size_t active() const;
+    //     float value( unsigned id ) const;
+    //     static unsigned index( unsigned id );         // slot, for side tables
+    // };
+
+    // coroutines (C++20) ; co_await a tween or a delay, resumed on the tick it ends. no polling, no allocation per await
+    // template<typename ALLOC = std::allocator<unsigned char> >
+    // class basic_script {                                 // coroutine type; frames allocated with ALLOC
+    //     void start() &&;                                 // runs detached, frees itself on return
+    //     bool done() const;                               // co_await script: runs it, resumes when it returns
+    // };
+    // typedef basic_script<> script;
+    // class director {
+    //     director( double now = 0 );
+    //     awaiter play( int type, float start, float end, double duration, float *target = 0 );
+    //     awaiter delay( double seconds );
+    //     void tick( double now );                         // resumes finished awaits: by scheduled end, then await order
+    //     double now() const;
+    //     const scheduler &timeline() const;
+    // };
+
+    // work-stealing thread pool for huge batches ; chunks aligned to output cache lines
+    // class parallel {
+    //     parallel( unsigned threads = hardware_concurrency(), size_t chunk_size = 4096 );
+    //     void ease( int type, const float *dt01, float *out, size_t n );
+    //     void ease( const int *types, const float *dt01, float *out, size_t n );
+    // };
+
+    // keyframe tracks ; cursor-cached sampling, binary search on seeks, batch sampling
+    // class track {
+    //     void add( float time, float value, int type = LINEAR );  // type eases the segment after this key
+    //     float sample( float time );
+    //     static void sample( track *tracks, size_t count, float time, float *out [, scratch &] );
+    // };
+
+    // multi-channel ; curve evaluated once, channels blended together. batch forms take count*N floats
+    // template<unsigned N> void lerp( int type, double dt01, const float *a, const float *b, float *out );
+    // template<unsigned N> void lerp( int type, const float *dt01, const float *a, const float *b, float *out, size_t count );
+    // void nlerp( int type, double dt01, const float *qa, const float *qb, float *out );  // quaternions, xyzw
+    // void slerp( int type, double dt01, const float *qa, const float *qb, float *out );  // + batch forms as lerp
+
+    // fixed point ; t in Q16 (0..65535), result in Q15 saturated, integer-only lookups. avx2: 16 lanes
+    // short ease_q15( int type, unsigned short dt );
+    // void ease_q15( int type, const unsigned short *dt, short *out, size_t n );
+    // double ease_q15_error( int type );  // max abs error, in Q15 LSBs
+
+    // instrumentation ; define TWEEN_STATS, zero cost otherwise. per thread counters, merged on snapshot
+    // struct stats {
+    //     enum COUNTER { EXACT, MEMOIZED, BATCHES, BATCHED, LUT_BUILDS, LUT_NS, EXACT_SAMPLES, EXACT_NS, MEMOIZED_SAMPLES, MEMOIZED_NS };
+    //     unsigned long long operator()( int type, int counter ) const;  // runtime curves share one row
+    //     unsigned long long total( int counter ) const;
+    //     stats &operator+=( const stats & ), &operator-=( const stats & );  // merge, deltas ; also + and -
+    //     std::string csv() const;
+    // };
+    // stats stats_snapshot();  // every thread, live or exited
+    // stats stats_thread();    // calling thread
+
+    // curve banks ; versioned binary tables + resolution, element type and error per curve, mmap-ed read-only across processes
+    // enum BANK_ELEMENT { BANK_FLOAT, BANK_DOUBLE, BANK_HALF };
+    // class bank_builder {
+    //     bank_builder( unsigned slots = 256, int element = BANK_FLOAT );
+    //     bank_builder &add( int type );  // builtin TYPE, or runtime curve stored by name
+    //     bank_builder &add( const char *name, const std::function<double( double )> &fn );
+    //     std::string data() const;
+    //     bool save( const char *path ) const;
+    // };
+    // class bank {
+    //     explicit bank( const char *path );  // + bool open( path )
+    //     bool ok() const;
+    //     size_t size() const;
+    //     const char *name( size_t i ) const; int type( size_t i ) const;  // type -1: custom
+    //     unsigned slots( size_t i ) const; int element( size_t i ) const; double max_error( size_t i ) const;
+    //     int find( const char *name ) const;
+    //     double operator()( size_t i, double dt01 ) const;
+    //     int install();  // memoized ease() reads the mapping, custom curves get registered ; idempotent
+    //     int id( size_t i ) const;  // after install()
+    // };
+
     enum TYPE
     {
         LINEAR,
@@ -142,395 +405,1302 @@ namespace tween
 
     // }
 
-    // implementation
+#   define $tween_xmacro(...) \
+    $tween( undefined, UNDEFINED ) \
+    \
+    $tween( linear, LINEAR ) \
+    $tween( quadin, QUADIN ) \
+    $tween( quadout, QUADOUT ) \
+    $tween( quadinout, QUADINOUT ) \
+    $tween( cubicin, CUBICIN ) \
+    $tween( cubicout, CUBICOUT ) \
+    $tween( cubicinout, CUBICINOUT ) \
+    $tween( quartin, QUARTIN ) \
+    $tween( quartout, QUARTOUT ) \
+    $tween( quartinout, QUARTINOUT ) \
+    $tween( quintin, QUINTIN ) \
+    $tween( quintout, QUINTOUT ) \
+    $tween( quintinout, QUINTINOUT ) \
+    $tween( sinein, SINEIN ) \
+    $tween( sineout, SINEOUT ) \
+    $tween( sineinout, SINEINOUT ) \
+    $tween( expoin, EXPOIN ) \
+    $tween( expoout, EXPOOUT ) \
+    $tween( expoinout, EXPOINOUT ) \
+    $tween( circin, CIRCIN ) \
+    $tween( circout, CIRCOUT ) \
+    $tween( circinout, CIRCINOUT ) \
+    $tween( elasticin, ELASTICIN ) \
+    $tween( elasticout, ELASTICOUT ) \
+    $tween( elasticinout, ELASTICINOUT ) \
+    $tween( backin, BACKIN ) \
+    $tween( backout, BACKOUT ) \
+    $tween( backinout, BACKINOUT ) \
+    $tween( bouncein, BOUNCEIN ) \
+    $tween( bounceout, BOUNCEOUT ) \
+    $tween( bounceinout, BOUNCEINOUT ) \
+    \
+    $tween( sinesquare, SINESQUARE ) \
+    $tween( exponential, EXPONENTIAL ) \
+    \
+    $tween( terrys1, SCHUBRING1 ) \
+    $tween( terrys2, SCHUBRING2 ) \
+    $tween( terrys3, SCHUBRING3 ) \
+    \
+    $tween( swing, SWING ) \
+    $tween( sinpi2, SINPI2 ) 
 
-    static inline //constexpr
-    double ease( int easetype, double t, bool memoized = false )
-    {
-        enum { LUT_SLOTS = 256 }; 
-        static float lut[TOTAL][LUT_SLOTS], *init = 0; 
-        if( !init ) {
-            init = &lut[0][0];
-            for( int j = 0; j < TOTAL; ++j ) {
-                for( int i = 0; i < LUT_SLOTS; ++i ) {
-                    lut[j][i] = ease( j, double(i) / (LUT_SLOTS-1), false );
-                }
+    // math policies: exact_math evaluates with libm (scalars) or the full-range
+    // polynomials (sse2/avx2 lanes); fast_math with the short ones of approx<V>.
+
+    struct exact_math {};
+    struct fast_math {};
+
+    // kernels
+
+    namespace detail {
+        constexpr double pi = 3.1415926535897932384626433832795;
+        constexpr double pi2 = 3.1415926535897932384626433832795 / 2;
+
+        // lanes: every curve below is written once against these few primitives,
+        // then instantiated for plain scalars and for sse2/avx2 registers.
+        // masks are bools for scalars and all-ones bit patterns for registers.
+
+#       define tween$scalar(T) \
+        static inline T vmin( T a, T b ) { return a < b ? a : b; } \
+        static inline T vmax( T a, T b ) { return a > b ? a : b; } \
+        static inline bool vlt( T a, T b ) { return a < b; } \
+        static inline bool veq( T a, T b ) { return a == b; } \
+        static inline T vsel( bool m, T a, T b ) { return m ? a : b; } \
+        static inline T vabs( T a ) { return std::abs( a ); } \
+        static inline T vsqrt( T a ) { return std::sqrt( a ); } \
+        static inline T vfloor( T a ) { return std::floor( a ); } \
+        static inline T vsin( T a ) { return std::sin( a ); } \
+        static inline T vcos( T a ) { return std::cos( a ); } \
+        static inline T vexp( T a ) { return std::exp( a ); } \
+        static inline T vexp2( T a ) { return std::pow( (T)2, a ); }
+        tween$scalar(float)
+        tween$scalar(double)
+        tween$scalar(long double)
+#       undef tween$scalar
+
+        // integer helpers for approx<V>: round to nearest, odd mask, 2^n.
+#       if tween$sse2
+        static inline float vrint( float a ) { return float( _mm_cvtss_si32( _mm_set_ss( a ) ) ); }
+#       else
+        static inline float vrint( float a ) { return float( int( a < 0 ? a - 0.5f : a + 0.5f ) ); }
+#       endif
+        static inline bool vodd( float k ) { return (int( k ) & 1) != 0; }
+        static inline float vexp2i( float n ) {
+            int i = (int( n ) + 127) << 23;
+            float f;
+            std::memcpy( &f, &i, sizeof(f) );
+            return f;
+        }
+
+#       if tween$sse2
+        struct f32x4 {
+            __m128 v;
+            f32x4() {}
+            f32x4( __m128 v ) : v(v) {}
+            f32x4( double f ) : v(_mm_set1_ps(float(f))) {}
+        };
+        static inline f32x4 operator+( f32x4 a, f32x4 b ) { return _mm_add_ps( a.v, b.v ); }
+        static inline f32x4 operator-( f32x4 a, f32x4 b ) { return _mm_sub_ps( a.v, b.v ); }
+        static inline f32x4 operator*( f32x4 a, f32x4 b ) { return _mm_mul_ps( a.v, b.v ); }
+        static inline f32x4 operator/( f32x4 a, f32x4 b ) { return _mm_div_ps( a.v, b.v ); }
+        static inline f32x4 operator-( f32x4 a ) { return _mm_xor_ps( a.v, _mm_set1_ps(-0.f) ); }
+        static inline f32x4 vmin( f32x4 a, f32x4 b ) { return _mm_min_ps( a.v, b.v ); }
+        static inline f32x4 vmax( f32x4 a, f32x4 b ) { return _mm_max_ps( a.v, b.v ); }
+        static inline f32x4 vlt( f32x4 a, f32x4 b ) { return _mm_cmplt_ps( a.v, b.v ); }
+        static inline f32x4 veq( f32x4 a, f32x4 b ) { return _mm_cmpeq_ps( a.v, b.v ); }
+        static inline f32x4 vsel( f32x4 m, f32x4 a, f32x4 b ) { return _mm_or_ps( _mm_and_ps( m.v, a.v ), _mm_andnot_ps( m.v, b.v ) ); }
+        static inline f32x4 vabs( f32x4 a ) { return _mm_andnot_ps( _mm_set1_ps(-0.f), a.v ); }
+        static inline f32x4 vsqrt( f32x4 a ) { return _mm_sqrt_ps( vmax( a, 0.0 ).v ); }
+        static inline f32x4 vfloor( f32x4 a ) {
+            // sse2 has no floor: truncate, step down the negatives, keep |a| >= 2^23 (already integral)
+            f32x4 i = _mm_cvtepi32_ps( _mm_cvttps_epi32( a.v ) );
+            i = i - f32x4( _mm_and_ps( vlt( a, i ).v, _mm_set1_ps(1.f) ) );
+            return vsel( vlt( vabs( a ), 8388608.0 ), i, a );
+        }
+        // cephes' sinf/cosf minimax polynomials after cody-waite reduction by pi/2.
+        // quarter = 0 for sin, 1 for cos. ~1e-7 abs error for |x| < 1e3.
+        static inline f32x4 vsincos( f32x4 x, int quarter ) {
+            __m128i qi = _mm_cvtps_epi32( _mm_mul_ps( x.v, _mm_set1_ps(0.636619772367581343f) ) );
+            f32x4 q = _mm_cvtepi32_ps( qi );
+            f32x4 r = x - q * 1.5703125 - q * 4.837512969970703125e-4 - q * 7.54978995489188216e-8, r2 = r * r;
+            f32x4 s = r + r * r2 * (-1.6666654611e-1 + r2 * (8.3321608736e-3 + r2 * -1.9515295891e-4));
+            f32x4 c = 1.0 - r2 * 0.5 + r2 * r2 * (4.166664568298827e-2 + r2 * (-1.388731625493765e-3 + r2 * 2.443315711809948e-5));
+            qi = _mm_add_epi32( qi, _mm_set1_epi32(quarter) );
+            f32x4 swap = _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( qi, _mm_set1_epi32(1) ), _mm_set1_epi32(1) ) );
+            f32x4 sign = _mm_castsi128_ps( _mm_slli_epi32( _mm_and_si128( qi, _mm_set1_epi32(2) ), 30 ) );
+            return _mm_xor_ps( vsel( swap, c, s ).v, sign.v );
+        }
+        static inline f32x4 vsin( f32x4 x ) { return vsincos( x, 0 ); }
+        static inline f32x4 vcos( f32x4 x ) { return vsincos( x, 1 ); }
+        // 2^x = 2^n * 2^f, n = round(x), f in [-0.5,0.5]. ~2e-7 rel error.
+        static inline f32x4 vexp2( f32x4 x ) {
+            x = vmin( vmax( x, -126.0 ), 126.0 );
+            __m128i n = _mm_cvtps_epi32( x.v );
+            f32x4 f = x - f32x4( _mm_cvtepi32_ps( n ) );
+            f32x4 p = 1.0 + f * (0.6931471805599453 + f * (0.2402265069591007 + f * (0.05550410866482158 + f * (0.009618129107628477 + f * (0.0013333558146428443 + f * 0.00015403530393381606)))));
+            return p * f32x4( _mm_castsi128_ps( _mm_slli_epi32( _mm_add_epi32( n, _mm_set1_epi32(127) ), 23 ) ) );
+        }
+        static inline f32x4 vexp( f32x4 x ) { return vexp2( x * 1.4426950408889634 ); }
+        static inline f32x4 vrint( f32x4 a ) { return _mm_cvtepi32_ps( _mm_cvtps_epi32( a.v ) ); }
+        static inline f32x4 vodd( f32x4 k ) {
+            __m128i one = _mm_set1_epi32(1);
+            return _mm_castsi128_ps( _mm_cmpeq_epi32( _mm_and_si128( _mm_cvtps_epi32( k.v ), one ), one ) );
+        }
+        static inline f32x4 vexp2i( f32x4 n ) { return _mm_castsi128_ps( _mm_slli_epi32( _mm_add_epi32( _mm_cvtps_epi32( n.v ), _mm_set1_epi32(127) ), 23 ) ); }
+#       endif
+
+#       if tween$avx2
+        struct f32x8 {
+            __m256 v;
+            f32x8() {}
+            f32x8( __m256 v ) : v(v) {}
+            f32x8( double f ) : v(_mm256_set1_ps(float(f))) {}
+        };
+        static inline f32x8 operator+( f32x8 a, f32x8 b ) { return _mm256_add_ps( a.v, b.v ); }
+        static inline f32x8 operator-( f32x8 a, f32x8 b ) { return _mm256_sub_ps( a.v, b.v ); }
+        static inline f32x8 operator*( f32x8 a, f32x8 b ) { return _mm256_mul_ps( a.v, b.v ); }
+        static inline f32x8 operator/( f32x8 a, f32x8 b ) { return _mm256_div_ps( a.v, b.v ); }
+        static inline f32x8 operator-( f32x8 a ) { return _mm256_xor_ps( a.v, _mm256_set1_ps(-0.f) ); }
+        static inline f32x8 vmin( f32x8 a, f32x8 b ) { return _mm256_min_ps( a.v, b.v ); }
+        static inline f32x8 vmax( f32x8 a, f32x8 b ) { return _mm256_max_ps( a.v, b.v ); }
+        static inline f32x8 vlt( f32x8 a, f32x8 b ) { return _mm256_cmp_ps( a.v, b.v, _CMP_LT_OQ ); }
+        static inline f32x8 veq( f32x8 a, f32x8 b ) { return _mm256_cmp_ps( a.v, b.v, _CMP_EQ_OQ ); }
+        static inline f32x8 vsel( f32x8 m, f32x8 a, f32x8 b ) { return _mm256_blendv_ps( b.v, a.v, m.v ); }
+        static inline f32x8 vabs( f32x8 a ) { return _mm256_andnot_ps( _mm256_set1_ps(-0.f), a.v ); }
+        static inline f32x8 vsqrt( f32x8 a ) { return _mm256_sqrt_ps( vmax( a, 0.0 ).v ); }
+        static inline f32x8 vfloor( f32x8 a ) { return _mm256_floor_ps( a.v ); }
+        static inline f32x8 vsincos( f32x8 x, int quarter ) {
+            __m256i qi = _mm256_cvtps_epi32( _mm256_mul_ps( x.v, _mm256_set1_ps(0.636619772367581343f) ) );
+            f32x8 q = _mm256_cvtepi32_ps( qi );
+            f32x8 r = x - q * 1.5703125 - q * 4.837512969970703125e-4 - q * 7.54978995489188216e-8, r2 = r * r;
+            f32x8 s = r + r * r2 * (-1.6666654611e-1 + r2 * (8.3321608736e-3 + r2 * -1.9515295891e-4));
+            f32x8 c = 1.0 - r2 * 0.5 + r2 * r2 * (4.166664568298827e-2 + r2 * (-1.388731625493765e-3 + r2 * 2.443315711809948e-5));
+            qi = _mm256_add_epi32( qi, _mm256_set1_epi32(quarter) );
+            f32x8 swap = _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( qi, _mm256_set1_epi32(1) ), _mm256_set1_epi32(1) ) );
+            f32x8 sign = _mm256_castsi256_ps( _mm256_slli_epi32( _mm256_and_si256( qi, _mm256_set1_epi32(2) ), 30 ) );
+            return _mm256_xor_ps( vsel( swap, c, s ).v, sign.v );
+        }
+        static inline f32x8 vsin( f32x8 x ) { return vsincos( x, 0 ); }
+        static inline f32x8 vcos( f32x8 x ) { return vsincos( x, 1 ); }
+        static inline f32x8 vexp2( f32x8 x ) {
+            x = vmin( vmax( x, -126.0 ), 126.0 );
+            __m256i n = _mm256_cvtps_epi32( x.v );
+            f32x8 f = x - f32x8( _mm256_cvtepi32_ps( n ) );
+            f32x8 p = 1.0 + f * (0.6931471805599453 + f * (0.2402265069591007 + f * (0.05550410866482158 + f * (0.009618129107628477 + f * (0.0013333558146428443 + f * 0.00015403530393381606)))));
+            return p * f32x8( _mm256_castsi256_ps( _mm256_slli_epi32( _mm256_add_epi32( n, _mm256_set1_epi32(127) ), 23 ) ) );
+        }
+        static inline f32x8 vexp( f32x8 x ) { return vexp2( x * 1.4426950408889634 ); }
+        static inline f32x8 vrint( f32x8 a ) { return _mm256_cvtepi32_ps( _mm256_cvtps_epi32( a.v ) ); }
+        static inline f32x8 vodd( f32x8 k ) {
+            __m256i one = _mm256_set1_epi32(1);
+            return _mm256_castsi256_ps( _mm256_cmpeq_epi32( _mm256_and_si256( _mm256_cvtps_epi32( k.v ), one ), one ) );
+        }
+        static inline f32x8 vexp2i( f32x8 n ) { return _mm256_castsi256_ps( _mm256_slli_epi32( _mm256_add_epi32( _mm256_cvtps_epi32( n.v ), _mm256_set1_epi32(127) ), 23 ) ); }
+#       endif
+
+#       if tween$cxx14
+        // cx: constexpr scalar lane. taylor series after range reduction; accurate
+        // to a few ulps of double, which is plenty for float/double tables baked at
+        // compile time. (slow: meant for constant evaluation only).
+        struct cx {
+            double v;
+            constexpr cx( double v = 0 ) : v(v) {}
+        };
+        constexpr cx operator+( cx a, cx b ) { return a.v + b.v; }
+        constexpr cx operator-( cx a, cx b ) { return a.v - b.v; }
+        constexpr cx operator*( cx a, cx b ) { return a.v * b.v; }
+        constexpr cx operator/( cx a, cx b ) { return a.v / b.v; }
+        constexpr cx operator-( cx a ) { return -a.v; }
+        constexpr cx vmin( cx a, cx b ) { return a.v < b.v ? a : b; }
+        constexpr cx vmax( cx a, cx b ) { return a.v > b.v ? a : b; }
+        constexpr bool vlt( cx a, cx b ) { return a.v < b.v; }
+        constexpr bool veq( cx a, cx b ) { return a.v == b.v; }
+        constexpr cx vsel( bool m, cx a, cx b ) { return m ? a : b; }
+        constexpr cx vabs( cx a ) { return a.v < 0 ? -a.v : a.v; }
+        constexpr cx vsqrt( cx a ) {
+            if( !(a.v > 0) ) return 0.0;
+            double x = a.v > 1 ? a.v : 1; // newton from above, monotonic
+            for( ;; ) {
+                double y = 0.5 * (x + a.v / x);
+                if( y >= x ) return x;
+                x = y;
+            }
+        }
+        constexpr cx vsincos( cx a, int quarter ) {
+            long long q = (long long)( a.v / pi2 + (a.v < 0 ? -0.5 : 0.5) ) + quarter;
+            double r = a.v - double(q - quarter) * pi2, r2 = r * r, sum = (q & 1) ? 1 : r, term = sum;
+            for( int n = (q & 1) ? 1 : 2; ; n += 2 ) {
+                term *= -r2 / (n * (n + 1));
+                if( sum + term == sum ) break;
+                sum += term;
+            }
+            return (q & 2) ? -sum : sum;
+        }
+        constexpr cx vsin( cx a ) { return vsincos( a, 0 ); }
+        constexpr cx vcos( cx a ) { return vsincos( a, 1 ); }
+        constexpr cx vexp( cx a ) {
+            const double ln2 = 0.69314718055994530942;
+            long long n = (long long)( a.v / ln2 + (a.v < 0 ? -0.5 : 0.5) );
+            double r = a.v - double(n) * ln2, sum = 1, term = 1;
+            for( int k = 1; ; ++k ) {
+                term *= r / k;
+                if( sum + term == sum ) break;
+                sum += term;
             }
+            for( ; n > 0; --n ) sum *= 2;
+            for( ; n < 0; ++n ) sum /= 2;
+            return sum;
+        }
+        constexpr cx vexp2( cx a ) { return vexp( a * 0.69314718055994530942 ); }
+#       endif
+
+        // approx<V>: fast_math lane over float, f32x4 or f32x8. forwards everything
+        // to V but the transcendentals, which skip the full-range reductions for
+        // short minimax polynomials. valid for the arguments the curves produce
+        // (|x| < 2^10 for sin/cos, |x| < 126 for exp2):
+        // sin ~6e-7 abs error (degree 7), exp2 ~4e-6 rel error (degree 4).
+        template<typename V>
+        struct approx {
+            V v;
+            approx() {}
+            template<typename U> approx( U u ) : v( V( u ) ) {}
+        };
+        template<typename V> static inline approx<V> operator+( approx<V> a, approx<V> b ) { return a.v + b.v; }
+        template<typename V> static inline approx<V> operator-( approx<V> a, approx<V> b ) { return a.v - b.v; }
+        template<typename V> static inline approx<V> operator*( approx<V> a, approx<V> b ) { return a.v * b.v; }
+        template<typename V> static inline approx<V> operator/( approx<V> a, approx<V> b ) { return a.v / b.v; }
+        template<typename V> static inline approx<V> operator-( approx<V> a ) { return -a.v; }
+        template<typename V> static inline approx<V> vmin( approx<V> a, approx<V> b ) { return vmin( a.v, b.v ); }
+        template<typename V> static inline approx<V> vmax( approx<V> a, approx<V> b ) { return vmax( a.v, b.v ); }
+        template<typename V> static inline auto vlt( approx<V> a, approx<V> b ) -> decltype( vlt( a.v, b.v ) ) { return vlt( a.v, b.v ); }
+        template<typename V> static inline auto veq( approx<V> a, approx<V> b ) -> decltype( veq( a.v, b.v ) ) { return veq( a.v, b.v ); }
+        template<typename V, typename M> static inline approx<V> vsel( M m, approx<V> a, approx<V> b ) { return vsel( m, a.v, b.v ); }
+        template<typename V> static inline approx<V> vabs( approx<V> a ) { return vabs( a.v ); }
+        template<typename V> static inline approx<V> vsqrt( approx<V> a ) { return vsqrt( a.v ); }
+        template<typename V> static inline approx<V> vsin( approx<V> a ) {
+            // sin(x) = (-1)^k sin(x - k*pi), two-step reduction is exact for |k| < 2^14
+            V k = vrint( a.v * V(1 / pi) ), r = a.v - k * V(3.140625) - k * V(9.67653589793e-4), r2 = r * r;
+            V s = r * (V(0.9999966159) + r2 * (V(-0.1666482838) + r2 * (V(0.008306325227) + r2 * V(-0.0001836365398))));
+            return vsel( vodd( k ), -s, s );
+        }
+        template<typename V> static inline approx<V> vcos( approx<V> a ) { return vsin( a + approx<V>( pi2 ) ); }
+        template<typename V> static inline approx<V> vexp2( approx<V> a ) {
+            // 2^x = 2^n * 2^f, n = round(x), f in [-0.5,0.5]; 2^0 stays exact
+            V x = vmin( vmax( a.v, V(-126) ), V(126) ), n = vrint( x ), f = x - n;
+            V p = V(1) + f * (V(0.6931136044) + f * (V(0.2402071108) + f * (V(0.05597688363) + f * V(0.009782912553))));
+            return p * vexp2i( n );
+        }
+        template<typename V> static inline approx<V> vexp( approx<V> a ) { return vexp2( a * approx<V>( 1.4426950408889634 ) ); }
+
+        template<typename MATH, typename V>
+        struct lane {
+            typedef V type;
+            static V get( V a ) { return a; }
+        };
+        template<typename V>
+        struct lane<fast_math, V> {
+            typedef approx<V> type;
+            static V get( approx<V> a ) { return a.v; }
+        };
+
+        // jet<V>: value, first and second derivative, carried through the curves
+        // in forward mode. one pass yields f, f' and f'' sharing every intermediate
+        // term (sin and cos of the same angle, the same exponential, ...). selects
+        // keep the piece they pick, so joins take its one-sided derivatives; ties
+        // in vmin/vmax keep the first operand.
+        template<typename V>
+        struct jet {
+            V v, d1, d2;
+            jet() {}
+            jet( V v, V d1, V d2 ) : v(v), d1(d1), d2(d2) {}
+            template<typename U> jet( U u ) : v( V( u ) ), d1( V(0) ), d2( V(0) ) {}
+        };
+        template<typename V> static inline jet<V> operator+( jet<V> a, jet<V> b ) { return jet<V>( a.v + b.v, a.d1 + b.d1, a.d2 + b.d2 ); }
+        template<typename V> static inline jet<V> operator-( jet<V> a, jet<V> b ) { return jet<V>( a.v - b.v, a.d1 - b.d1, a.d2 - b.d2 ); }
+        template<typename V> static inline jet<V> operator-( jet<V> a ) { return jet<V>( -a.v, -a.d1, -a.d2 ); }
+        template<typename V> static inline jet<V> operator*( jet<V> a, jet<V> b ) {
+            return jet<V>( a.v * b.v, a.d1 * b.v + a.v * b.d1, a.d2 * b.v + V(2) * a.d1 * b.d1 + a.v * b.d2 );
+        }
+        template<typename V> static inline jet<V> operator/( jet<V> a, jet<V> b ) {
+            V q = a.v / b.v, q1 = (a.d1 - q * b.d1) / b.v;
+            return jet<V>( q, q1, (a.d2 - V(2) * q1 * b.d1 - q * b.d2) / b.v );
+        }
+        template<typename V> static inline auto vlt( jet<V> a, jet<V> b ) -> decltype( vlt( a.v, b.v ) ) { return vlt( a.v, b.v ); }
+        template<typename V> static inline auto veq( jet<V> a, jet<V> b ) -> decltype( veq( a.v, b.v ) ) { return veq( a.v, b.v ); }
+        template<typename V, typename M> static inline jet<V> vsel( M m, jet<V> a, jet<V> b ) {
+            return jet<V>( vsel( m, a.v, b.v ), vsel( m, a.d1, b.d1 ), vsel( m, a.d2, b.d2 ) );
+        }
+        template<typename V> static inline jet<V> vmin( jet<V> a, jet<V> b ) { return vsel( vlt( b.v, a.v ), b, a ); }
+        template<typename V> static inline jet<V> vmax( jet<V> a, jet<V> b ) { return vsel( vlt( a.v, b.v ), b, a ); }
+        template<typename V> static inline jet<V> vabs( jet<V> a ) {
+            V s = vsel( vlt( a.v, V(0) ), V(-1), V(1) );
+            return jet<V>( vabs( a.v ), s * a.d1, s * a.d2 );
+        }
+        template<typename V> static inline jet<V> vsqrt( jet<V> a ) {
+            V r = vsqrt( a.v ), r2 = V(2) * r, d1 = a.d1 / r2;
+            return jet<V>( r, d1, (a.d2 - V(2) * d1 * d1) / r2 );
+        }
+        template<typename V> static inline jet<V> vsin( jet<V> a ) {
+            V s = vsin( a.v ), c = vcos( a.v );
+            return jet<V>( s, c * a.d1, c * a.d2 - s * a.d1 * a.d1 );
+        }
+        template<typename V> static inline jet<V> vcos( jet<V> a ) {
+            V s = vsin( a.v ), c = vcos( a.v );
+            return jet<V>( c, -s * a.d1, -(s * a.d2) - c * a.d1 * a.d1 );
+        }
+        template<typename V> static inline jet<V> vexp( jet<V> a ) {
+            V e = vexp( a.v );
+            return jet<V>( e, e * a.d1, e * (a.d2 + a.d1 * a.d1) );
+        }
+        template<typename V> static inline jet<V> vexp2( jet<V> a ) {
+            V e = vexp2( a.v ), g = V(0.69314718055994530942) * a.d1;
+            return jet<V>( e, e * g, e * (V(0.69314718055994530942) * a.d2 + g * g) );
         }
 
-        using namespace std;
+        // piecewise: scalar lanes (bool masks) branch and evaluate one side only;
+        // registers have no branch to take, so they evaluate both and select.
+        template<typename M> struct lanes { enum { value = 1 }; };
+        template<> struct lanes<bool> { enum { value = 0 }; };
+        template<typename M> static inline tween$constexpr bool vtest( M ) { return false; }
+        static inline tween$constexpr bool vtest( bool m ) { return m; }
+#       define tween$piecewise(M, A, B) \
+        ( lanes<decltype( M )>::value ? vsel( M, A, B ) : vtest( M ) ? (A) : (B) )
+
+        // curves: piecewise cases go through tween$piecewise, the rest is straight-line.
+        // unspecialized types (LINEAR, UNDEFINED, out of range) map to f(t) = t.
+
+        // Modeled after the line y = x
+        template<int TYPE>
+        struct curve {
+            template<typename V> static inline tween$constexpr V eval( V p ) { return p; }
+        };
+
+#       define tween$curve(TYPE) \
+        template<> struct curve<TYPE> { template<typename V> static inline tween$constexpr V eval( V p ); }; \
+        template<typename V> inline tween$constexpr V curve<TYPE>::eval( V p )
+
+        // Modeled after the parabola y = x^2
+        tween$curve(QUADIN) {
+            return p * p;
+        }
 
-        const double is_looped = 0;     /* used to be a param long time ago */
-        const double d = 1.f;           /* used to be a param long time ago */ /* (d)estination, final time */
-        const double pi = 3.1415926535897932384626433832795;
-        const double pi2 = 3.1415926535897932384626433832795 / 2;
+        // Modeled after the parabola y = -x^2 + 2x
+        tween$curve(QUADOUT) {
+            return -(p * (p - V(2)));
+        }
 
-        /* tiny optimizations { */
+        // Modeled after the piecewise quadratic
+        // y = (1/2)((2x)^2)             ; [0, 0.5)
+        // y = -(1/2)((2x-1)*(2x-3) - 1) ; [0.5, 1]
+        tween$curve(QUADINOUT) {
+            return tween$piecewise( vlt( p, V(0.5) ), V(2) * p * p, (V(-2) * p * p) + (V(4) * p) - V(1) );
+        }
 
-        if( is_looped ) {
-            if( t < 0 ) {
-                t = -t;
-            }
-            // todo: optimize me?
-            while( t > d ) {
-                t -= d;
-            }            
-        } else {
-            // clamp
-            if( t < 0.f ) {
-                t = 0;
-            } 
-            else
-            if( t > d ) {
-                t = d;
-            }
+        // Modeled after the cubic y = x^3
+        tween$curve(CUBICIN) {
+            return p * p * p;
         }
 
-        if( memoized ) {
-            return lut[ easetype ][ int(t*(LUT_SLOTS-1)) ];
+        // Modeled after the cubic y = (x - 1)^3 + 1
+        tween$curve(CUBICOUT) {
+            V f = (p - V(1));
+            return f * f * f + V(1);
         }
 
-        /* } */
+        // Modeled after the piecewise cubic
+        // y = (1/2)((2x)^3)       ; [0, 0.5)
+        // y = (1/2)((2x-2)^3 + 2) ; [0.5, 1]
+        tween$curve(CUBICINOUT) {
+            V f = ((V(2) * p) - V(2));
+            return tween$piecewise( vlt( p, V(0.5) ), V(4) * p * p * p, V(0.5) * f * f * f + V(1) );
+        }
 
-        double p = t/d;
+        // Modeled after the quartic x^4
+        tween$curve(QUARTIN) {
+            return p * p * p * p;
+        }
 
-        switch( easetype )
-        {
-            // Modeled after the line y = x
-            default:
-            case TYPE::LINEAR: {
-                return p;
-            }
+        // Modeled after the quartic y = 1 - (x - 1)^4
+        tween$curve(QUARTOUT) {
+            V f = (p - V(1));
+            return f * f * f * (V(1) - p) + V(1);
+        }
 
-            // Modeled after the parabola y = x^2
-            case TYPE::QUADIN: {
-                return p * p;
-            }
+        // Modeled after the piecewise quartic
+        // y = (1/2)((2x)^4)        ; [0, 0.5)
+        // y = -(1/2)((2x-2)^4 - 2) ; [0.5, 1]
+        tween$curve(QUARTINOUT) {
+            V f = (p - V(1));
+            return tween$piecewise( vlt( p, V(0.5) ), V(8) * p * p * p * p, V(-8) * f * f * f * f + V(1) );
+        }
 
-            // Modeled after the parabola y = -x^2 + 2x
-            case TYPE::QUADOUT: {
-                return -(p * (p - 2));
-            }
+        // Modeled after the quintic y = x^5
+        tween$curve(QUINTIN) {
+            return p * p * p * p * p;
+        }
 
-            // Modeled after the piecewise quadratic
-            // y = (1/2)((2x)^2)             ; [0, 0.5)
-            // y = -(1/2)((2x-1)*(2x-3) - 1) ; [0.5, 1]
-            case TYPE::QUADINOUT: {
-                if(p < 0.5) {
-                    return 2 * p * p;
-                }
-                else {
-                    return (-2 * p * p) + (4 * p) - 1;
-                }
-            }
+        // Modeled after the quintic y = (x - 1)^5 + 1
+        tween$curve(QUINTOUT) {
+            V f = (p - V(1));
+            return f * f * f * f * f + V(1);
+        }
 
-            // Modeled after the cubic y = x^3
-            case TYPE::CUBICIN: {
-                return p * p * p;
-            }
+        // Modeled after the piecewise quintic
+        // y = (1/2)((2x)^5)       ; [0, 0.5)
+        // y = (1/2)((2x-2)^5 + 2) ; [0.5, 1]
+        tween$curve(QUINTINOUT) {
+            V f = ((V(2) * p) - V(2));
+            return tween$piecewise( vlt( p, V(0.5) ), V(16) * p * p * p * p * p, V(0.5) * f * f * f * f * f + V(1) );
+        }
 
-            // Modeled after the cubic y = (x - 1)^3 + 1
-            case TYPE::CUBICOUT: {
-                double f = (p - 1);
-                return f * f * f + 1;
-            }
+        // Modeled after quarter-cycle of sine wave
+        tween$curve(SINEIN) {
+            return vsin( (p - V(1)) * V(pi2) ) + V(1);
+        }
 
-            // Modeled after the piecewise cubic
-            // y = (1/2)((2x)^3)       ; [0, 0.5)
-            // y = (1/2)((2x-2)^3 + 2) ; [0.5, 1]
-            case TYPE::CUBICINOUT: {
-                if(p < 0.5) {
-                    return 4 * p * p * p;
-                }
-                else {
-                    double f = ((2 * p) - 2);
-                    return 0.5 * f * f * f + 1;
-                }
-            }
+        // Modeled after quarter-cycle of sine wave (different phase)
+        tween$curve(SINEOUT) {
+            return vsin( p * V(pi2) );
+        }
 
-            // Modeled after the quartic x^4
-            case TYPE::QUARTIN: {
-                return p * p * p * p;
-            }
+        // Modeled after half sine wave
+        tween$curve(SINEINOUT) {
+            return V(0.5) * (V(1) - vcos( p * V(pi) ));
+        }
 
-            // Modeled after the quartic y = 1 - (x - 1)^4
-            case TYPE::QUARTOUT: {
-                double f = (p - 1);
-                return f * f * f * (1 - p) + 1;
-            }
+        // Modeled after shifted quadrant IV of unit circle
+        tween$curve(CIRCIN) {
+            return V(1) - vsqrt( V(1) - (p * p) );
+        }
 
-            // Modeled after the piecewise quartic
-            // y = (1/2)((2x)^4)        ; [0, 0.5)
-            // y = -(1/2)((2x-2)^4 - 2) ; [0.5, 1]
-            case TYPE::QUARTINOUT:  {
-                if(p < 0.5) {
-                    return 8 * p * p * p * p;
-                }
-                else {
-                    double f = (p - 1);
-                    return -8 * f * f * f * f + 1;
-                }
-            }
+        // Modeled after shifted quadrant II of unit circle
+        tween$curve(CIRCOUT) {
+            return vsqrt( (V(2) - p) * p );
+        }
 
-            // Modeled after the quintic y = x^5
-            case TYPE::QUINTIN:  {
-                return p * p * p * p * p;
-            }
+        // Modeled after the piecewise circular function
+        // y = (1/2)(1 - sqrt(1 - 4x^2))           ; [0, 0.5)
+        // y = (1/2)(sqrt(-(2x - 3)*(2x - 1)) + 1) ; [0.5, 1]
+        tween$curve(CIRCINOUT) {
+            return tween$piecewise( vlt( p, V(0.5) ),
+                V(0.5) * (V(1) - vsqrt( vmax( V(1) - V(4) * (p * p), V(0) ) )),
+                V(0.5) * (vsqrt( vmax( -((V(2) * p) - V(3)) * ((V(2) * p) - V(1)), V(0) ) ) + V(1)) );
+        }
 
-            // Modeled after the quintic y = (x - 1)^5 + 1
-            case TYPE::QUINTOUT:  {
-                double f = (p - 1);
-                return f * f * f * f * f + 1;
-            }
+        // Modeled after the exponential function y = 2^(10(x - 1))
+        tween$curve(EXPOIN) {
+            return tween$piecewise( veq( p, V(0) ), V(0), vexp2( V(10) * (p - V(1)) ) );
+        }
 
-            // Modeled after the piecewise quintic
-            // y = (1/2)((2x)^5)       ; [0, 0.5)
-            // y = (1/2)((2x-2)^5 + 2) ; [0.5, 1]
-            case TYPE::QUINTINOUT:  {
-                if(p < 0.5) {
-                    return 16 * p * p * p * p * p;
-                }
-                else {
-                    double f = ((2 * p) - 2);
-                    return  0.5 * f * f * f * f * f + 1;
-                }
-            }
+        // Modeled after the exponential function y = -2^(-10x) + 1
+        tween$curve(EXPOOUT) {
+            return tween$piecewise( veq( p, V(1) ), V(1), V(1) - vexp2( V(-10) * p ) );
+        }
 
-            // Modeled after quarter-cycle of sine wave
-            case TYPE::SINEIN: {
-                return sin((p - 1) * pi2) + 1;
-            }
+        // Modeled after the piecewise exponential
+        // y = (1/2)2^(10(2x - 1))         ; [0,0.5)
+        // y = -(1/2)*2^(-10(2x - 1))) + 1 ; [0.5,1]
+        tween$curve(EXPOINOUT) {
+            V r = tween$piecewise( vlt( p, V(0.5) ),
+                V(0.5) * vexp2( (V(20) * p) - V(10) ),
+                V(-0.5) * vexp2( (V(-20) * p) + V(10) ) + V(1) );
+            return tween$piecewise( veq( p, V(0) ), V(0), tween$piecewise( veq( p, V(1) ), V(1), r ) );
+        }
 
-            // Modeled after quarter-cycle of sine wave (different phase)
-            case TYPE::SINEOUT: {
-                return sin(p * pi2);
-            }
+        // Modeled after the damped sine wave y = sin(13pi/2*x)*pow(2, 10 * (x - 1))
+        tween$curve(ELASTICIN) {
+            return vsin( V(13 * pi2) * p ) * vexp2( V(10) * (p - V(1)) );
+        }
 
-            // Modeled after half sine wave
-            case TYPE::SINEINOUT: {
-                return 0.5 * (1 - cos(p * pi));
-            }
+        // Modeled after the damped sine wave y = sin(-13pi/2*(x + 1))*pow(2, -10x) + 1
+        tween$curve(ELASTICOUT) {
+            return vsin( V(-13 * pi2) * (p + V(1)) ) * vexp2( V(-10) * p ) + V(1);
+        }
 
-            // Modeled after shifted quadrant IV of unit circle
-            case TYPE::CIRCIN: {
-                return 1 - sqrt(1 - (p * p));
-            }
+        // Modeled after the piecewise exponentially-damped sine wave:
+        // y = (1/2)*sin(13pi/2*(2*x))*pow(2, 10 * ((2*x) - 1))      ; [0,0.5)
+        // y = (1/2)*(sin(-13pi/2*((2x-1)+1))*pow(2,-10(2*x-1)) + 2) ; [0.5, 1]
+        tween$curve(ELASTICINOUT) {
+            return tween$piecewise( vlt( p, V(0.5) ),
+                V(0.5) * vsin( V(13 * pi2) * (V(2) * p) ) * vexp2( V(10) * ((V(2) * p) - V(1)) ),
+                V(0.5) * (vsin( V(-13 * pi2) * ((V(2) * p - V(1)) + V(1)) ) * vexp2( V(-10) * (V(2) * p - V(1)) ) + V(2)) );
+        }
 
-            // Modeled after shifted quadrant II of unit circle
-            case TYPE::CIRCOUT: {
-                return sqrt((2 - p) * p);
+        // Modeled (originally) after the overshooting cubic y = x^3-x*sin(x*pi)
+        tween$curve(BACKIN) {
+            V s = V(1.70158f);
+            return p * p * ((s + V(1)) * p - s);
+        }
+
+        // Modeled (originally) after overshooting cubic y = 1-((1-x)^3-(1-x)*sin((1-x)*pi))
+        tween$curve(BACKOUT) {
+            V s = V(1.70158f), q = p - V(1);
+            return q * q * ((s + V(1)) * q + s) + V(1);
+        }
+
+        // Modeled (originally) after the piecewise overshooting cubic function:
+        // y = (1/2)*((2x)^3-(2x)*sin(2*x*pi))           ; [0, 0.5)
+        // y = (1/2)*(1-((1-x)^3-(1-x)*sin((1-x)*pi))+1) ; [0.5, 1]
+        tween$curve(BACKINOUT) {
+            V s = V(1.70158f * 1.525f), a = p * V(2), b = p * V(2) - V(2);
+            return tween$piecewise( vlt( p, V(0.5) ), V(0.5) * a * a * (a * s + a - s), V(0.5) * (V(2) + b * b * (b * s + b + s)) );
+        }
+
+        template<typename V>
+        static inline tween$constexpr V bounceout( V p ) {
+            return tween$piecewise( vlt( p, V(4/11.0) ), (V(121) * p * p) / V(16.0),
+                   tween$piecewise( vlt( p, V(8/11.0) ), (V(363/40.0) * p * p) - (V(99/10.0) * p) + V(17/5.0),
+                   tween$piecewise( vlt( p, V(9/10.0) ), (V(4356/361.0) * p * p) - (V(35442/1805.0) * p) + V(16061/1805.0),
+                                              (V(54/5.0) * p * p) - (V(513/25.0) * p) + V(268/25.0) ) ) );
+        }
+
+        tween$curve(BOUNCEIN) {
+            return V(1) - bounceout( V(1) - p );
+        }
+        tween$curve(BOUNCEOUT) {
+            return bounceout( p );
+        }
+        tween$curve(BOUNCEINOUT) {
+            return tween$piecewise( vlt( p, V(0.5) ), V(0.5) * (V(1) - bounceout( V(1) - p * V(2) )), V(0.5) * bounceout( p * V(2) - V(1) ) + V(0.5) );
+        }
+        tween$curve(SINESQUARE) {
+            V A = vsin( p * V(pi2) );
+            return A * A;
+        }
+        tween$curve(EXPONENTIAL) {
+            return V(1) / (V(1) + vexp( V(6) - V(12) * p ));
+        }
+        tween$curve(SCHUBRING1) {
+            return V(2) * (p + (V(0.5) - p) * vabs( V(0.5) - p )) - V(0.5);
+        }
+        tween$curve(SCHUBRING2) {
+            V p1pass = V(2) * (p + (V(0.5) - p) * vabs( V(0.5) - p )) - V(0.5);
+            V p2pass = V(2) * (p1pass + (V(0.5) - p1pass) * vabs( V(0.5) - p1pass )) - V(0.5);
+            return (p1pass + p2pass) / V(2);
+        }
+        tween$curve(SCHUBRING3) {
+            V p1pass = V(2) * (p + (V(0.5) - p) * vabs( V(0.5) - p )) - V(0.5);
+            return V(2) * (p1pass + (V(0.5) - p1pass) * vabs( V(0.5) - p1pass )) - V(0.5);
+        }
+        tween$curve(SWING) {
+            return ((-vcos( V(pi) * p ) * V(0.5)) + V(0.5));
+        }
+        tween$curve(SINPI2) {
+            return vsin( p * V(pi2) );
+        }
+
+#       undef tween$curve
+#       undef tween$piecewise
+    }
+
+    // half: ieee binary16, storage only (tables). converts from double at compile
+    // time (C++14) and to float at runtime. round to nearest, ties away from zero.
+
+    struct half {
+        unsigned short bits;
+
+        half() = default;
+        tween$constexpr half( double v ) : bits( encode( v ) ) {}
+        operator float() const {
+            int e = (bits >> 10) & 31, m = bits & 1023;
+            float f = e == 31 ? (m ? NAN : INFINITY) : e ? std::ldexp( float(m | 1024), e - 25 ) : std::ldexp( float(m), -24 );
+            return bits & 0x8000 ? -f : f;
+        }
+
+        static tween$constexpr unsigned short encode( double v ) {
+            unsigned short sign = v < 0 ? 0x8000 : 0;
+            double a = v < 0 ? -v : v;
+            if( a != a ) return 0x7e00;
+            if( a >= 65520.0 ) return sign | 0x7c00;
+            if( a < 1 / 16384.0 ) { // subnormal: units of 2^-24
+                return sign | (unsigned short)( a * 16777216.0 + 0.5 );
             }
+            int e = 0;
+            while( a >= 2 ) a /= 2, ++e;
+            while( a < 1 ) a *= 2, --e;
+            unsigned m = (unsigned)( (a - 1) * 1024 + 0.5 );
+            if( m == 1024 ) m = 0, ++e;
+            return e > 15 ? sign | 0x7c00 : sign | (unsigned short)( (e + 15) << 10 | m );
+        }
+    };
 
-            // Modeled after the piecewise circular function
-            // y = (1/2)(1 - sqrt(1 - 4x^2))           ; [0, 0.5)
-            // y = (1/2)(sqrt(-(2x - 3)*(2x - 1)) + 1) ; [0.5, 1]
-            case TYPE::CIRCINOUT: {
-                if(p < 0.5) {
-                    return 0.5 * (1 - sqrt(1 - 4 * (p * p)));
-                }
-                else {
-                    return 0.5 * (sqrt(-((2 * p) - 3) * ((2 * p) - 1)) + 1);
+#   if tween$cxx14
+
+    // baked<SLOTS,T>: compile-time generated lookup tables. each row is its own
+    // constant expression, so tables land in read-only data and get shared by
+    // every process mapping the binary. lookups match ease(type,t,true).
+
+    namespace detail {
+        template<int TYPE, unsigned SLOTS, typename T>
+        struct baked_row {
+            T data[SLOTS];
+            constexpr baked_row() : data() {
+                for( unsigned i = 0; i < SLOTS; ++i ) {
+                    data[i] = T( curve<TYPE>::eval( cx( double(i) / (SLOTS-1) ) ).v );
                 }
             }
+            static const baked_row rom;
+        };
+        template<int TYPE, unsigned SLOTS, typename T>
+        constexpr baked_row<TYPE, SLOTS, T> baked_row<TYPE, SLOTS, T>::rom = baked_row<TYPE, SLOTS, T>();
+
+        template<unsigned SLOTS, typename T, typename SEQ = std::make_integer_sequence<int, TOTAL> >
+        struct baked_rows;
+        template<unsigned SLOTS, typename T, int... I>
+        struct baked_rows<SLOTS, T, std::integer_sequence<int, I...> > {
+            static constexpr const T *rows[TOTAL] = { baked_row<I, SLOTS, T>::rom.data... };
+        };
+        template<unsigned SLOTS, typename T, int... I>
+        constexpr const T *baked_rows<SLOTS, T, std::integer_sequence<int, I...> >::rows[TOTAL];
+    }
+
+    template<unsigned SLOTS = 256, typename T = float>
+    struct baked : detail::baked_rows<SLOTS, T> {
+        static_assert( SLOTS >= 2, "baked tables need at least two slots" );
+        enum { slots = SLOTS };
 
-            // Modeled after the exponential function y = 2^(10(x - 1))
-            case TYPE::EXPOIN: {
-                return (p == 0.0) ? p : pow(2, 10 * (p - 1));
+        static inline T ease( int type, double t ) {
+            if( unsigned(type) >= TOTAL ) type = TYPE::LINEAR;
+            t = t < 0 ? 0 : t > 1 ? 1 : t;
+            return baked::rows[ type ][ int(t*(SLOTS-1)) ];
+        }
+    };
+
+#   endif
+
+    // instrumentation: define TWEEN_STATS to count, per thread and per curve,
+    // scalar calls (exact/memoized), batch calls and sizes, lazy table builds
+    // and their time, plus the latency of one scalar call in TWEEN_STATS_SAMPLING.
+    // counters are thread-owned relaxed atomics (no locked instructions); the
+    // snapshot merges every live thread and the ones already gone. without
+    // TWEEN_STATS the hooks expand to nothing and snapshots are all zeros.
+    // the hub and the thread blocks are plain inline: one per program.
+
+    struct stats {
+        enum COUNTER {
+            EXACT, MEMOIZED,                     // scalar ease() calls
+            BATCHES, BATCHED,                    // batch ease()/ease_fast() calls, total elements
+            LUT_BUILDS, LUT_NS,                  // lazy tables built (memo, runtime curve cache, q15) and time spent
+            EXACT_SAMPLES, EXACT_NS,             // sampled latency of exact calls
+            MEMOIZED_SAMPLES, MEMOIZED_NS,       // sampled latency of memoized calls
+            COUNTERS
+        };
+        unsigned long long count[TOTAL + 1][COUNTERS];  // [TOTAL]: runtime curves and out of range ids
+
+        stats() : count() {}
+
+        static int slot( int type ) {
+            return unsigned(type) < TOTAL ? type : int(TOTAL);
+        }
+        unsigned long long operator()( int type, int counter ) const {
+            return count[ slot( type ) ][ counter ];
+        }
+        unsigned long long total( int counter ) const {
+            unsigned long long sum = 0;
+            for( int i = 0; i <= TOTAL; ++i ) sum += count[i][counter];
+            return sum;
+        }
+
+        // merge, and deltas between two snapshots
+        stats &operator+=( const stats &other ) {
+            for( int i = 0; i <= TOTAL; ++i ) for( int c = 0; c < COUNTERS; ++c ) count[i][c] += other.count[i][c];
+            return *this;
+        }
+        stats &operator-=( const stats &other ) {
+            for( int i = 0; i <= TOTAL; ++i ) for( int c = 0; c < COUNTERS; ++c ) count[i][c] -= other.count[i][c];
+            return *this;
+        }
+        friend stats operator+( stats a, const stats &b ) { return a += b; }
+        friend stats operator-( stats a, const stats &b ) { return a -= b; }
+
+        // one line per curve with any activity, header first
+        std::string csv() const;
+    };
+
+    namespace detail {
+        struct stats_block;
+        struct stats_hub {
+            std::mutex lock;
+            std::vector<stats_block *> live;
+            stats retired;
+        };
+        inline stats_hub &hub() {
+            static stats_hub h;
+            return h;
+        }
+
+        struct stats_block {
+            std::atomic<unsigned long long> count[TOTAL + 1][stats::COUNTERS];
+
+            stats_block() {
+                for( int i = 0; i <= TOTAL; ++i ) for( int c = 0; c < stats::COUNTERS; ++c ) count[i][c].store( 0, std::memory_order_relaxed );
+                std::lock_guard<std::mutex> lock( hub().lock );
+                hub().live.push_back( this );
+            }
+            ~stats_block() {
+                stats_hub &h = hub();
+                std::lock_guard<std::mutex> lock( h.lock );
+                read( h.retired );
+                h.live.erase( std::find( h.live.begin(), h.live.end(), this ) );
             }
 
-            // Modeled after the exponential function y = -2^(-10x) + 1
-            case TYPE::EXPOOUT: {
-                return (p == 1.0) ? p : 1 - pow(2, -10 * p);
+            // owner thread only: plain load + store, no read-modify-write
+            unsigned long long add( int type, int counter, unsigned long long n ) {
+                std::atomic<unsigned long long> &c = count[ stats::slot( type ) ][ counter ];
+                unsigned long long v = c.load( std::memory_order_relaxed ) + n;
+                c.store( v, std::memory_order_relaxed );
+                return v;
             }
+            void read( stats &s ) const {
+                for( int i = 0; i <= TOTAL; ++i ) for( int c = 0; c < stats::COUNTERS; ++c ) s.count[i][c] += count[i][c].load( std::memory_order_relaxed );
+            }
+        };
+        inline stats_block &local_stats() {
+            static thread_local stats_block b;
+            return b;
+        }
 
-            // Modeled after the piecewise exponential
-            // y = (1/2)2^(10(2x - 1))         ; [0,0.5)
-            // y = -(1/2)*2^(-10(2x - 1))) + 1 ; [0.5,1]
-            case TYPE::EXPOINOUT: {
-                if(p == 0.0 || p == 1.0) return p;
-                
-                if(p < 0.5) {
-                    return 0.5 * pow(2, (20 * p) - 10);
-                }
-                else {
-                    return -0.5 * pow(2, (-20 * p) + 10) + 1;
+        inline unsigned long long stats_ns( std::chrono::steady_clock::time_point start ) {
+            return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>( std::chrono::steady_clock::now() - start ).count();
+        }
+
+        // scalar call: counted, and timed once every TWEEN_STATS_SAMPLING calls of its kind
+        struct stats_call {
+            stats_block &b;
+            int type, counter;
+            bool timed;
+            std::chrono::steady_clock::time_point start;
+            stats_call( int type, int counter ) : b( local_stats() ), type( type ), counter( counter ) {
+                unsigned long long n = b.add( type, counter, 1 );
+                timed = TWEEN_STATS_SAMPLING > 0 && n % (TWEEN_STATS_SAMPLING > 0 ? TWEEN_STATS_SAMPLING : 1) == 0;
+                if( timed ) start = std::chrono::steady_clock::now();
+            }
+            ~stats_call() {
+                if( timed ) {
+                    unsigned long long ns = stats_ns( start );
+                    b.add( type, counter == stats::EXACT ? stats::EXACT_SAMPLES : stats::MEMOIZED_SAMPLES, 1 );
+                    b.add( type, counter == stats::EXACT ? stats::EXACT_NS : stats::MEMOIZED_NS, ns );
                 }
             }
-
-            // Modeled after the damped sine wave y = sin(13pi/2*x)*pow(2, 10 * (x - 1))
-            case TYPE::ELASTICIN: {
-                return sin(13 * pi2 * p) * pow(2, 10 * (p - 1));
+        };
+
+        // lazy table build: counted and timed
+        struct stats_build {
+            int type;
+            std::chrono::steady_clock::time_point start;
+            explicit stats_build( int type ) : type( type ), start( std::chrono::steady_clock::now() ) {}
+            ~stats_build() {
+                stats_block &b = local_stats();
+                b.add( type, stats::LUT_BUILDS, 1 );
+                b.add( type, stats::LUT_NS, stats_ns( start ) );
             }
+        };
+    }
 
-            // Modeled after the damped sine wave y = sin(-13pi/2*(x + 1))*pow(2, -10x) + 1
-            case TYPE::ELASTICOUT: {
-                return sin(-13 * pi2 * (p + 1)) * pow(2, -10 * p) + 1;
-            }
+#   ifdef TWEEN_STATS
+#       define tween$stats_call( type, counter ) detail::stats_call tween$stats_call_( type, counter )
+#       define tween$stats_build( type )         detail::stats_build tween$stats_build_( type )
+#       define tween$stats_batch( type, n )      ( detail::local_stats().add( type, stats::BATCHES, 1 ), detail::local_stats().add( type, stats::BATCHED, n ) )
+#   else
+#       define tween$stats_call( type, counter )
+#       define tween$stats_build( type )
+#       define tween$stats_batch( type, n )      ( (void)0 )
+#   endif
+
+    // every thread, live or exited
+    static inline
+    stats stats_snapshot() {
+        stats s;
+#       ifdef TWEEN_STATS
+        detail::stats_hub &h = detail::hub();
+        std::lock_guard<std::mutex> lock( h.lock );
+        s = h.retired;
+        for( detail::stats_block *b : h.live ) b->read( s );
+#       endif
+        return s;
+    }
 
-            // Modeled after the piecewise exponentially-damped sine wave:
-            // y = (1/2)*sin(13pi/2*(2*x))*pow(2, 10 * ((2*x) - 1))      ; [0,0.5)
-            // y = (1/2)*(sin(-13pi/2*((2x-1)+1))*pow(2,-10(2*x-1)) + 2) ; [0.5, 1]
-            case TYPE::ELASTICINOUT: {
-                if(p < 0.5) {
-                    return 0.5 * sin(13 * pi2 * (2 * p)) * pow(2, 10 * ((2 * p) - 1));
-                }
-                else {
-                    return 0.5 * (sin(-13 * pi2 * ((2 * p - 1) + 1)) * pow(2, -10 * (2 * p - 1)) + 2);
+    // calling thread only
+    static inline
+    stats stats_thread() {
+        stats s;
+#       ifdef TWEEN_STATS
+        detail::local_stats().read( s );
+#       endif
+        return s;
+    }
+
+    // wrap modes: map any t onto [0,1] in constant time, before the clamp.
+    // t - floor(t) is exact in floating point, so the phase is as precise as
+    // t itself however large it grows (use doubles for long running clocks).
+    //   WRAP_CLAMP    clamp to [0,1], the default
+    //   WRAP_REPEAT   0..1, 0..1, ...
+    //   WRAP_MIRROR   0..1, 1..0, ... each leg a full period
+    //   WRAP_PINGPONG 0..1..0 within each period, as pingpong()
+    //   WRAP_HOLD     repeat once started, hold 0 before (delayed loops)
+
+    enum WRAP { WRAP_CLAMP, WRAP_REPEAT, WRAP_MIRROR, WRAP_PINGPONG, WRAP_HOLD };
+
+    namespace detail {
+        template<int MODE, typename V>
+        static inline V vwrap( V t ) {
+            V u = t - vfloor( t );
+            switch( MODE ) {
+                default: return t;
+                case WRAP_REPEAT: return u;
+                case WRAP_MIRROR: {
+                    V m = t - V(2) * vfloor( t * V(0.5) );
+                    return vsel( vlt( V(1), m ), V(2) - m, m );
                 }
+                case WRAP_PINGPONG: return vsel( vlt( u, V(0.5) ), u + u, V(2) - u - u );
+                case WRAP_HOLD: return vsel( vlt( t, V(0) ), V(0), u );
             }
+        }
 
-            // Modeled (originally) after the overshooting cubic y = x^3-x*sin(x*pi)
-            case TYPE::BACKIN: { /*
-                return p * p * p - p * sin(p * pi); */
-                double s = 1.70158f;
-                return p * p * ((s + 1) * p - s);
+        template<int MODE, typename T>
+        static inline void wrap( const T *t, T *out, size_t n, size_t i = 0 ) {
+            for( ; i < n; ++i ) {
+                out[i] = vwrap<MODE>( t[i] );
             }
+        }
+        template<int MODE>
+        static inline void wrap( const float *t, float *out, size_t n ) {
+            size_t i = 0;
+#           if tween$avx2
+            for( ; i + 8 <= n; i += 8 ) {
+                _mm256_storeu_ps( out + i, vwrap<MODE>( f32x8( _mm256_loadu_ps( t + i ) ) ).v );
+            }
+#           endif
+#           if tween$sse2
+            for( ; i + 4 <= n; i += 4 ) {
+                _mm_storeu_ps( out + i, vwrap<MODE>( f32x4( _mm_loadu_ps( t + i ) ) ).v );
+            }
+#           endif
+            wrap<MODE, float>( t, out, n, i );
+        }
+    }
+
+    template<typename T>
+    static inline T wrap( int mode, T t ) {
+        switch( mode ) {
+            default: return t < 0 ? T(0) : t > 1 ? T(1) : t;
+            case WRAP_REPEAT: return detail::vwrap<WRAP_REPEAT>( t );
+            case WRAP_MIRROR: return detail::vwrap<WRAP_MIRROR>( t );
+            case WRAP_PINGPONG: return detail::vwrap<WRAP_PINGPONG>( t );
+            case WRAP_HOLD: return detail::vwrap<WRAP_HOLD>( t );
+        }
+    }
 
-            // Modeled (originally) after overshooting cubic y = 1-((1-x)^3-(1-x)*sin((1-x)*pi))
-            case TYPE::BACKOUT: { /*
-                double f = (1 - p);
-                return 1 - (f * f * f - f * sin(f * pi)); */
-                double s = 1.70158f;
-                return --p, 1.f * (p*p*((s+1)*p + s) + 1);
+    template<typename T>
+    static inline void wrap( int mode, const T *t, T *out, size_t n ) {
+        switch( mode ) {
+            default: for( size_t i = 0; i < n; ++i ) out[i] = t[i] < 0 ? T(0) : t[i] > 1 ? T(1) : t[i];
+            break; case WRAP_REPEAT: detail::wrap<WRAP_REPEAT>( t, out, n );
+            break; case WRAP_MIRROR: detail::wrap<WRAP_MIRROR>( t, out, n );
+            break; case WRAP_PINGPONG: detail::wrap<WRAP_PINGPONG>( t, out, n );
+            break; case WRAP_HOLD: detail::wrap<WRAP_HOLD>( t, out, n );
+        }
+    }
+
+    namespace detail {
+        // batches with a wrap mode: wrapped in blocks on the stack, then eased
+        template<typename T, typename EASE>
+        static inline void wrap_blocks( int mode, const T *t, T *out, size_t n, const EASE &ease ) {
+            enum { BLOCK = 256 };
+            T block[BLOCK];
+            for( size_t i = 0; i < n; i += BLOCK ) {
+                size_t m = n - i < size_t(BLOCK) ? n - i : size_t(BLOCK);
+                tween::wrap( mode, t + i, block, m );
+                ease( block, out + i, m );
             }
+        }
+    }
 
-            // Modeled (originally) after the piecewise overshooting cubic function:
-            // y = (1/2)*((2x)^3-(2x)*sin(2*x*pi))           ; [0, 0.5)
-            // y = (1/2)*(1-((1-x)^3-(1-x)*sin((1-x)*pi))+1) ; [0.5, 1]
-            case TYPE::BACKINOUT: { /*
-                if(p < 0.5) {
-                    double f = 2 * p;
-                    return 0.5 * (f * f * f - f * sin(f * pi));
-                }
-                else {
-                    double f = (1 - (2*p - 1));
-                    return 0.5 * (1 - (f * f * f - f * sin(f * pi))) + 0.5;
-                } */
-                double s = 1.70158f * 1.525f;
-                if (p < 0.5) {
-                    return p *= 2, 0.5 * p * p * (p*s+p-s);
-                }
-                else {
-                    return p = p * 2 - 2, 0.5 * (2 + p*p*(p*s+p+s));
+    // implementation
+
+    enum BANK_ELEMENT { BANK_FLOAT, BANK_DOUBLE, BANK_HALF };  /* rows of curve banks, see class bank */
+
+    namespace detail {
+        template<typename T> struct identity { typedef T type; };
+
+        // a row of an installed curve bank: mapped read-only, never unmapped.
+        // nearest() is the lookup of the memo tables, linear() interpolates.
+        struct bank_row {
+            const void *data;
+            unsigned slots;
+            int element;
+            double at( unsigned i ) const {
+                switch( element ) {
+                    default: return static_cast<const float *>( data )[i];
+                    case BANK_DOUBLE: return static_cast<const double *>( data )[i];
+                    case BANK_HALF: return static_cast<const half *>( data )[i];
                 }
             }
+            float nearest( double t ) const {
+                return float( at( unsigned( t * (slots - 1) ) ) );
+            }
+            double linear( double t ) const {
+                double x = (t < 0 ? 0 : t > 1 ? 1 : t) * (slots - 1);
+                unsigned i = unsigned( x ) < slots - 1 ? unsigned( x ) : slots - 2;
+                return at( i ) + (at( i + 1 ) - at( i )) * (x - i);
+            }
+        };
+        inline std::atomic<const bank_row *> *bank_rows() {
+            static std::atomic<const bank_row *> rows[TOTAL]; /* zero-initialized: no bank */
+            return rows;
+        }
 
-#           define tween$bounceout(p) ( \
-                (p) < 4/11.0 ? (121 * (p) * (p))/16.0 : \
-                (p) < 8/11.0 ? (363/40.0 * (p) * (p)) - (99/10.0 * (p)) + 17/5.0 : \
-                (p) < 9/10.0 ? (4356/361.0 * (p) * (p)) - (35442/1805.0 * (p)) + 16061/1805.0 \
-                           : (54/5.0 * (p) * (p)) - (513/25.0 * (p)) + 268/25.0 )
+        // runtime curves: ids above UNDEFINED, assigned in order. entries live in
+        // chunks that are never moved nor freed, and are immutable once count
+        // publishes them, so readers only need the acquire load of count.
+        // registry, cache and bank rows are plain inline: one per program, shared
+        // by every translation unit.
+        struct custom_curve {
+            std::function<double( double )> fn;
+            std::string name;
+            const bank_row *row = 0; /* backed by a curve bank */
+        };
+        struct curve_registry {
+            enum { CHUNK_BITS = 10, CHUNK = 1 << CHUNK_BITS, CHUNKS = 1024 };
+            std::atomic<unsigned> count;
+            std::mutex writer;
+            custom_curve *chunks[CHUNKS];
+            constexpr curve_registry() : count(0), writer(), chunks() {}
+        };
+        inline curve_registry &registry() {
+            static curve_registry r; /* constant-initialized */
+            return r;
+        }
+        inline const custom_curve *find_curve( int type ) {
+            curve_registry &r = registry();
+            unsigned i = unsigned(type) - (UNDEFINED + 1);
+            if( i >= unsigned(curve_registry::CHUNKS * curve_registry::CHUNK) || i >= r.count.load( std::memory_order_acquire ) ) return 0;
+            return &r.chunks[ i >> curve_registry::CHUNK_BITS ][ i & (curve_registry::CHUNK - 1) ];
+        }
 
-            case TYPE::BOUNCEIN: {
-                return 1 - tween$bounceout(1 - p);
+        // memo tables of runtime curves: a fixed, set-associative cache of
+        // TWEEN_CURVE_CACHE_BYTES. each line is a seqlock: readers never block and
+        // retry on the exact curve when a line is being rewritten; misses rebuild
+        // into a round-robin victim of the set.
+        struct curve_cache {
+            enum { SLOTS = 256, WAYS = 4 };
+            struct line {
+                std::atomic<unsigned> seq; /* odd while being written */
+                std::atomic<int> type;
+                std::atomic<float> v[SLOTS];
+            };
+            enum { SETS = TWEEN_CURVE_CACHE_BYTES / (WAYS * sizeof(line)) > 0 ? TWEEN_CURVE_CACHE_BYTES / (WAYS * sizeof(line)) : 1 };
+            line lines[SETS][WAYS];
+            std::atomic<unsigned> victim[SETS];
+        };
+        inline float cached( int type, const custom_curve &c, double t ) {
+            static curve_cache cache; /* zero-initialized: no line holds a runtime id */
+            const int slot = int(t * (curve_cache::SLOTS - 1));
+            const unsigned set = (unsigned(type) * 2654435761u) % curve_cache::SETS;
+            for( int w = 0; w < curve_cache::WAYS; ++w ) {
+                curve_cache::line &l = cache.lines[set][w];
+                unsigned seq = l.seq.load( std::memory_order_acquire );
+                if( (seq & 1) || l.type.load( std::memory_order_relaxed ) != type ) continue;
+                float v = l.v[slot].load( std::memory_order_relaxed );
+                std::atomic_thread_fence( std::memory_order_acquire );
+                if( l.seq.load( std::memory_order_relaxed ) == seq ) return v;
+            }
+            curve_cache::line &l = cache.lines[set][ cache.victim[set].fetch_add( 1, std::memory_order_relaxed ) % curve_cache::WAYS ];
+            unsigned seq = l.seq.load( std::memory_order_relaxed );
+            if( (seq & 1) || !l.seq.compare_exchange_strong( seq, seq + 1, std::memory_order_relaxed ) ) {
+                return float( c.fn( t ) );
+            }
+            std::atomic_thread_fence( std::memory_order_release );
+            tween$stats_build( type );
+            l.type.store( type, std::memory_order_relaxed );
+            for( int i = 0; i < curve_cache::SLOTS; ++i ) {
+                l.v[i].store( float( c.fn( double(i) / (curve_cache::SLOTS - 1) ) ), std::memory_order_relaxed );
             }
+            float v = l.v[slot].load( std::memory_order_relaxed );
+            l.seq.store( seq + 2, std::memory_order_release );
+            return v;
+        }
 
-            case TYPE::BOUNCEOUT: {
-                return tween$bounceout(p);
+        // exact evaluation at precision T: one switch, then the kernel
+        template<typename T>
+        static inline T exact( int type, T p ) {
+#   define $tween( unused, type ) case TYPE::type: return curve<TYPE::type>::eval( p );
+            switch( type ) {
+                default: if( const custom_curve *c = find_curve( type ) ) return T( c->fn( double(p) ) );
+                         return p;
+                $tween_xmacro(expand cases)
             }
+#   undef $tween
+        }
 
-            case TYPE::BOUNCEINOUT: {
-                if(p < 0.5) {
-                    return 0.5 * (1 - tween$bounceout(1 - p * 2));
+        // memoization: 256-slot float tables, shared by every precision
+        static inline float memo( int type, double t ) {
+            enum { LUT_SLOTS = 256 }; 
+            if( unsigned(type) >= TOTAL ) {
+                if( const custom_curve *c = find_curve( type ) ) return c->row ? c->row->nearest( t ) : cached( type, *c, t );
+                type = TYPE::LINEAR;
+            }
+            if( const bank_row *row = bank_rows()[ type ].load( std::memory_order_acquire ) ) {
+                return row->nearest( t );
+            }
+#           ifdef TWEEN_BAKED_LUT
+            // tables were generated at compile time; no init, no mutable state.
+            return baked<LUT_SLOTS>::ease( type, t );
+#           else
+            // tables are built lazily, per curve, by the first thread asking for them.
+            // concurrent callers answer exactly until the table is published.
+            enum { EMPTY, BUILDING, READY };
+            static float lut[TOTAL][LUT_SLOTS];
+            static std::atomic<int> state[TOTAL]; /* zero-initialized: all EMPTY */
+            if( state[ type ].load( std::memory_order_acquire ) != READY ) {
+                int expected = EMPTY;
+                if( state[ type ].compare_exchange_strong( expected, BUILDING, std::memory_order_acq_rel ) ) {
+                    tween$stats_build( type );
+                    for( int i = 0; i < LUT_SLOTS; ++i ) {
+                        lut[ type ][ i ] = float( exact<double>( type, double(i) / (LUT_SLOTS-1) ) );
+                    }
+                    state[ type ].store( READY, std::memory_order_release );
                 }
-                else {
-                    return 0.5 * tween$bounceout((p * 2 - 1)) + 0.5;
+                else if( expected != READY ) {
+                    return float( exact<double>( type, t ) );
                 }
             }
+            return lut[ type ][ int(t*(LUT_SLOTS-1)) ];
+#           endif
+        }
+    }
 
-#           undef tween$bounceout
+    // ease<T>: the evaluation core at precision T (float, double, long double).
+    // never deduced, so ease( type, t ) keeps calling the double version below.
+    // float results stay within 3e-6 of double ones over [0,1] (worst: BOUNCE*).
 
-            case TYPE::SINESQUARE: {
-                double A = sin((p)*pi2);
-                return A*A;
-            }
+    template<typename T>
+    static inline //constexpr
+    T ease( int easetype, typename detail::identity<T>::type t, bool memoized = false, int wrap = WRAP_CLAMP )
+    {
+        const T d = 1;             /* used to be a param long time ago */ /* (d)estination, final time */
 
-            case TYPE::EXPONENTIAL: {
-                return 1/(1+exp(6-12*(p)));                
-            }
+        /* tiny optimizations { */
 
-            case TYPE::SCHUBRING1: {
-                return 2*(p+(0.5f-p)*abs(0.5f-p))-0.5f;                
-            }
+        if( wrap != WRAP_CLAMP ) {
+            t = tween::wrap( wrap, t );
+        }
 
-            case TYPE::SCHUBRING2: {
-                double p1pass= 2*(p+(0.5f-p)*abs(0.5f-p))-0.5f;
-                double p2pass= 2*(p1pass+(0.5f-p1pass)*abs(0.5f-p1pass))-0.5f;
-                double pAvg=(p1pass+p2pass)/2;
-                return pAvg;
-            }
+        // clamp
+        if( t < 0 ) {
+            t = 0;
+        } 
+        else
+        if( t > d ) {
+            t = d;
+        }
+
+        tween$stats_call( easetype, memoized ? stats::MEMOIZED : stats::EXACT );
+
+        if( memoized ) {
+            return T( detail::memo( easetype, t ) );
+        }
+
+        /* } */
+
+        return detail::exact<T>( easetype, t/d );
+    }
 
-            case TYPE::SCHUBRING3: {
-                double p1pass= 2*(p+(0.5f-p)*abs(0.5f-p))-0.5f;
-                double p2pass= 2*(p1pass+(0.5f-p1pass)*abs(0.5f-p1pass))-0.5f;
-                return p2pass;
+    static inline
+    double ease( int easetype, double t, bool memoized = false, int wrap = WRAP_CLAMP ) {
+        return ease<double>( easetype, t, memoized, wrap );
+    }
+
+    namespace detail {
+        inline int add_curve( const char *name, const std::function<double( double )> &fn, const bank_row *row ) {
+            typedef curve_registry registry;
+            registry &r = detail::registry();
+            std::lock_guard<std::mutex> lock( r.writer );
+            unsigned i = r.count.load( std::memory_order_relaxed );
+            if( i >= registry::CHUNKS * registry::CHUNK ) {
+                return -1;
+            }
+            custom_curve *&chunk = r.chunks[ i >> registry::CHUNK_BITS ];
+            if( !chunk ) {
+                chunk = new custom_curve[ registry::CHUNK ];
             }
+            chunk[ i & (registry::CHUNK - 1) ].fn = fn;
+            chunk[ i & (registry::CHUNK - 1) ].name = name ? name : "CUSTOM";
+            chunk[ i & (registry::CHUNK - 1) ].row = row;
+            r.count.store( i + 1, std::memory_order_release );
+            return int(TYPE::UNDEFINED) + 1 + int(i);
+        }
+    }
+
+    // runtime curves: register_curve() returns a new id, above UNDEFINED, that
+    // ease(), nameof() and the memoized path take like any TYPE (-1 when full).
+    // registration locks; lookups don't. curves stay registered for the process.
+    static inline
+    int register_curve( const char *name, const std::function<double( double )> &fn ) {
+        return detail::add_curve( name, fn, 0 );
+    }
 
-            case TYPE::SWING: {
-                return ((-cos(pi * p) * 0.5) + 0.5);
+    // inverse easing: t such that ease( type, t ) == value, for the monotonic
+    // curves. closed forms where they exist; SCHUBRING* bracket t in a lazily
+    // built table (t at 1024 uniform values) and refine it with regula falsi,
+    // 2-4 evaluations. values outside the curve's range clamp to 0 or 1.
+    // BACK*, ELASTIC*, BOUNCE*, runtime and unknown curves are not invertible:
+    // false, as for a NaN value.
+
+    namespace detail {
+        static inline double power_inverse( double v, int n, bool in, bool out ) {
+            // in: t^n, out: 1-(1-t)^n, inout: 2^(n-1) t^n then mirrored
+            double k = in && out ? double( 1 << (n - 1) ) : 1;
+            bool low = !out || (in && v < 0.5);
+            double x = low ? v / k : (1 - v) / k;
+            double r = n == 2 ? std::sqrt( x ) : n == 3 ? std::cbrt( x ) : std::pow( x, 1.0 / n );
+            return low ? r : 1 - r;
+        }
+        // v within [ease( type, 0 ), ease( type, 1 )]
+        static inline bool inverse_closed( int type, double v, double &t ) {
+            switch( type ) {
+                default: return false;
+                break; case TYPE::LINEAR: t = v;
+                break; case TYPE::QUADIN: case TYPE::QUADOUT: case TYPE::QUADINOUT:
+                    t = power_inverse( v, 2, type != TYPE::QUADOUT, type != TYPE::QUADIN );
+                break; case TYPE::CUBICIN: case TYPE::CUBICOUT: case TYPE::CUBICINOUT:
+                    t = power_inverse( v, 3, type != TYPE::CUBICOUT, type != TYPE::CUBICIN );
+                break; case TYPE::QUARTIN: case TYPE::QUARTOUT: case TYPE::QUARTINOUT:
+                    t = power_inverse( v, 4, type != TYPE::QUARTOUT, type != TYPE::QUARTIN );
+                break; case TYPE::QUINTIN: case TYPE::QUINTOUT: case TYPE::QUINTINOUT:
+                    t = power_inverse( v, 5, type != TYPE::QUINTOUT, type != TYPE::QUINTIN );
+                break; case TYPE::SINEIN: t = 1 + std::asin( v - 1 ) / pi2;
+                break; case TYPE::SINEOUT: case TYPE::SINPI2: t = std::asin( v ) / pi2;
+                break; case TYPE::SINEINOUT: case TYPE::SWING: case TYPE::SINESQUARE: t = std::acos( 1 - 2 * v ) / pi;
+                break; case TYPE::EXPOIN: t = v <= 0 ? 0 : 1 + std::log2( v ) / 10;
+                break; case TYPE::EXPOOUT: t = v >= 1 ? 1 : -std::log2( 1 - v ) / 10;
+                break; case TYPE::EXPOINOUT: t = v <= 0 ? 0 : v >= 1 ? 1 : v < 0.5 ? (std::log2( 2 * v ) + 10) / 20 : (10 - std::log2( 2 - 2 * v )) / 20;
+                break; case TYPE::CIRCIN: t = std::sqrt( 1 - (1 - v) * (1 - v) );
+                break; case TYPE::CIRCOUT: t = 1 - std::sqrt( 1 - v * v );
+                break; case TYPE::CIRCINOUT: t = v < 0.5 ? std::sqrt( 1 - (1 - 2 * v) * (1 - 2 * v) ) / 2 : 1 - std::sqrt( 1 - (2 * v - 1) * (2 * v - 1) ) / 2;
+                break; case TYPE::EXPONENTIAL: t = v <= 0 ? 0 : v >= 1 ? 1 : (6 - std::log( 1 / v - 1 )) / 12;
             }
+            t = t < 0 ? 0 : t > 1 ? 1 : t;
+            return true;
+        }
 
-            case TYPE::SINPI2: {
-                return sin(p * pi2);
+        enum { INVERSE_SLOTS = 1024 };
+        // regula falsi, illinois variant: superlinear, stays bracketed. flo and fhi
+        // are ease( type, lo|hi ) - v.
+        static inline double inverse_search( int type, double v, double lo, double hi, double flo, double fhi, int steps ) {
+            for( int side = 0, i = 0; i < steps && hi - lo > 1e-15; ++i ) {
+                double t = fhi != flo ? (lo * fhi - hi * flo) / (fhi - flo) : 0.5 * (lo + hi), f = ease( type, t ) - v;
+                if( std::abs( f ) < 1e-15 ) return t;
+                if( (f < 0) == (flo < 0) ) {
+                    lo = t, flo = f;
+                    if( side == -1 ) fhi *= 0.5;
+                    side = -1;
+                } else {
+                    hi = t, fhi = f;
+                    if( side == +1 ) flo *= 0.5;
+                    side = +1;
+                }
+            }
+            return std::abs( flo ) < std::abs( fhi ) ? lo : hi;
+        }
+        static inline const double *inverse_row( int type ) {
+            enum { EMPTY, BUILDING, READY };
+            static double row[TOTAL][INVERSE_SLOTS + 1];
+            static std::atomic<int> state[TOTAL];
+            if( state[type].load( std::memory_order_acquire ) != READY ) {
+                int expected = EMPTY;
+                if( !state[type].compare_exchange_strong( expected, BUILDING, std::memory_order_acq_rel ) ) {
+                    return expected == READY ? row[type] : 0;
+                }
+                double lo = ease( type, 0.0 ), hi = ease( type, 1.0 );
+                row[type][0] = 0, row[type][INVERSE_SLOTS] = 1;
+                for( int i = 1; i < INVERSE_SLOTS; ++i ) {
+                    double v = lo + (hi - lo) * i / double(INVERSE_SLOTS);
+                    row[type][i] = inverse_search( type, v, row[type][i-1], 1, ease( type, row[type][i-1] ) - v, hi - v, 200 );
+                }
+                state[type].store( READY, std::memory_order_release );
             }
+            return row[type];
         }
     }
 
-#   define $tween_xmacro(...) \
-    $tween( undefined, UNDEFINED ) \
-    \
-    $tween( linear, LINEAR ) \
-    $tween( quadin, QUADIN ) \
-    $tween( quadout, QUADOUT ) \
-    $tween( quadinout, QUADINOUT ) \
-    $tween( cubicin, CUBICIN ) \
-    $tween( cubicout, CUBICOUT ) \
-    $tween( cubicinout, CUBICINOUT ) \
-    $tween( quartin, QUARTIN ) \
-    $tween( quartout, QUARTOUT ) \
-    $tween( quartinout, QUARTINOUT ) \
-    $tween( quintin, QUINTIN ) \
-    $tween( quintout, QUINTOUT ) \
-    $tween( quintinout, QUINTINOUT ) \
-    $tween( sinein, SINEIN ) \
-    $tween( sineout, SINEOUT ) \
-    $tween( sineinout, SINEINOUT ) \
-    $tween( expoin, EXPOIN ) \
-    $tween( expoout, EXPOOUT ) \
-    $tween( expoinout, EXPOINOUT ) \
-    $tween( circin, CIRCIN ) \
-    $tween( circout, CIRCOUT ) \
-    $tween( circinout, CIRCINOUT ) \
-    $tween( elasticin, ELASTICIN ) \
-    $tween( elasticout, ELASTICOUT ) \
-    $tween( elasticinout, ELASTICINOUT ) \
-    $tween( backin, BACKIN ) \
-    $tween( backout, BACKOUT ) \
-    $tween( backinout, BACKINOUT ) \
-    $tween( bouncein, BOUNCEIN ) \
-    $tween( bounceout, BOUNCEOUT ) \
-    $tween( bounceinout, BOUNCEINOUT ) \
-    \
-    $tween( sinesquare, SINESQUARE ) \
-    $tween( exponential, EXPONENTIAL ) \
-    \
-    $tween( terrys1, SCHUBRING1 ) \
-    $tween( terrys2, SCHUBRING2 ) \
-    $tween( terrys3, SCHUBRING3 ) \
-    \
-    $tween( swing, SWING ) \
-    $tween( sinpi2, SINPI2 ) 
+    static inline
+    bool invertible( int type ) {
+        if( unsigned(type) >= TOTAL ) {
+            return false;
+        }
+        switch( type ) {
+            default: return true;
+            case TYPE::BACKIN: case TYPE::BACKOUT: case TYPE::BACKINOUT:
+            case TYPE::ELASTICIN: case TYPE::ELASTICOUT: case TYPE::ELASTICINOUT:
+            case TYPE::BOUNCEIN: case TYPE::BOUNCEOUT: case TYPE::BOUNCEINOUT:
+            case TYPE::UNDEFINED: return false;
+            case TYPE::SCHUBRING1: case TYPE::SCHUBRING2: case TYPE::SCHUBRING3: return true;
+        }
+    }
 
-    // interface for tweeners; includes memoization
+    static inline
+    bool ease_inverse( int type, double value, double &t ) {
+        if( !invertible( type ) || value != value ) {
+            return false;
+        }
+        // out of range first: the closed forms are only defined within it
+        double lo = ease( type, 0.0 ), hi = ease( type, 1.0 );
+        if( value <= lo || value >= hi ) {
+            return t = value <= lo ? 0 : 1, true;
+        }
+        if( detail::inverse_closed( type, value, t ) ) {
+            return true;
+        }
+        const double *row = detail::inverse_row( type );
+        if( !row ) { /* table being built by another thread */
+            return t = detail::inverse_search( type, value, 0, 1, lo - value, hi - value, 200 ), true;
+        }
+        // row[i] solves lo + (hi - lo) * i / SLOTS, so the bracket's residuals come for free
+        const double step = (hi - lo) / double(detail::INVERSE_SLOTS), f = (value - lo) / step;
+        int i = int(f) < detail::INVERSE_SLOTS ? int(f) : detail::INVERSE_SLOTS - 1;
+        t = detail::inverse_search( type, value, row[i], row[i+1], lo + step * i - value, lo + step * (i + 1) - value, 16 );
+        return true;
+    }
+
+    // static dispatch: easer<TYPE> resolves the curve at compile time, so calls
+    // and compositions of them inline down to straight-line code. exact, same
+    // results as ease( TYPE, dt01 ); easer<TYPE, fast_math> matches ease_fast().
+
+    template<int TYPE, typename MATH = exact_math>
+    struct easer {
+        enum { type = TYPE };
+        double operator()( double dt01 ) const {
+            return detail::curve<TYPE>::eval( dt01 < 0 ? 0.0 : dt01 > 1 ? 1.0 : dt01 );
+        }
+    };
+    template<int TYPE>
+    struct easer<TYPE, fast_math> {
+        enum { type = TYPE };
+        double operator()( double dt01 ) const {
+            return detail::curve<TYPE>::eval( detail::approx<float>( dt01 < 0 ? 0.0f : dt01 > 1 ? 1.0f : float(dt01) ) ).v;
+        }
+    };
+
+    // interface for tweeners
 #   define $tween(fn,type) \
     static inline double fn( double dt01 ) { \
-        return tween::ease( tween::type, dt01 ); \
+        return tween::easer<tween::type>()( dt01 ); \
     }
     $tween_xmacro(expand functions)
 #   undef $tween
 
     static inline
     const char *nameof( int type ) {
+        if( const detail::custom_curve *c = detail::find_curve( type ) ) {
+            return c->name.c_str();
+        }
 #   define $tween( unused, type ) case TYPE::type: return #type;
         switch(type) { 
             default:
@@ -539,6 +1709,23 @@ namespace tween
 #   undef $tween
     }
 
+    inline std::string stats::csv() const {
+        std::string out = "type,exact,memoized,batches,batched,lut_builds,lut_ns,exact_samples,exact_ns,memoized_samples,memoized_ns\n";
+        for( int i = 0; i <= TOTAL; ++i ) {
+            unsigned long long any = 0;
+            for( int c = 0; c < COUNTERS; ++c ) any |= count[i][c];
+            if( !any ) continue;
+            out += i < TOTAL ? nameof( i ) : "RUNTIME";
+            for( int c = 0; c < COUNTERS; ++c ) {
+                char buf[24];
+                std::snprintf( buf, sizeof(buf), ",%llu", count[i][c] );
+                out += buf;
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
     static inline
     double ping( double dt01 ) {
         return dt01;
@@ -568,4 +1755,2259 @@ namespace tween
     static inline double inout( double dt01, EASE &ease ) { 
         return dt01 < 0.5f ? ease(dt01*2) * 0.5f : out(dt01*2-1, ease) * 0.5f + 0.5f;
     }
+
+    // compile-time modifiers; compose easers (or any stateless functor) as types:
+    // easer_inout< easer_chain< easer<BOUNCEIN>, easer<QUADIN> > >()( dt01 )
+
+    template<typename EASE>
+    struct easer_in {
+        double operator()( double dt01 ) const { return EASE()( dt01 ); }
+    };
+    template<typename EASE>
+    struct easer_out {
+        double operator()( double dt01 ) const { return 1 - EASE()( 1 - dt01 ); }
+    };
+    template<typename EASE>
+    struct easer_inout {
+        double operator()( double dt01 ) const {
+            return dt01 < 0.5f ? EASE()( dt01*2 ) * 0.5f : easer_out<EASE>()( dt01*2-1 ) * 0.5f + 0.5f;
+        }
+    };
+    template<typename EASE>
+    struct easer_pingpong {
+        double operator()( double dt01 ) const { return EASE()( pingpong( dt01 ) ); }
+    };
+    template<typename EASE>
+    struct easer_pongping {
+        double operator()( double dt01 ) const { return EASE()( pongping( dt01 ) ); }
+    };
+    template<typename OUTER, typename INNER>
+    struct easer_chain {
+        double operator()( double dt01 ) const { return OUTER()( INNER()( dt01 ) ); }
+    };
+    template<typename A, typename B>
+    struct easer_product {
+        double operator()( double dt01 ) const { return A()( dt01 ) * B()( dt01 ); }
+    };
+
+    // interpolated lookup tables, resolution chosen per curve. max_error() is the
+    // measured max abs error against exact ease(), sampled 16x per slot interval
+    // and refined around each interval's worst sample.
+    // S is the storage type: float by default, half to halve the footprint.
+
+    enum LOOKUP
+    {
+        LUT_NEAREST,     // rounds to the closest slot
+        LUT_LINEAR,      // linear interpolation between slots
+        LUT_HERMITE      // cubic hermite, interior tangents taken from the exact curve
+    };
+
+    template<typename S = float>
+    class basic_lut {
+        int type_, mode_;
+        unsigned slots_;
+        std::vector<S> v, m;  // values; tangents (hermite only) scaled by slot width
+        double error_;
+
+        typedef std::function<double( double )> function;
+
+        // 17 samples, then two 8x zooms around the worst one: kinks (bounces, inout
+        // joins) and jumps (EXPOIN at 0) peak between the first samples.
+        double interval_error( unsigned i, const function &f ) const {
+            const double step = 1.0 / (slots_ - 1);
+            double e = 0, at = i;
+            for( double width = 1; width > 1 / 128.0; width /= 8 ) {
+                double from = at - width / 2 > i ? at - width / 2 : i, to = from + width < i + 1 ? from + width : i + 1;
+                for( int k = 0; k <= 16; ++k ) {
+                    double x = from + (to - from) * k / 16, t = x * step, d = std::abs( (*this)( t ) - f( t ) );
+                    if( d > e ) e = d, at = x;
+                }
+            }
+            return e;
+        }
+        void fit( unsigned slot, double a, double b, const function &f ) {
+            unsigned i = slot ? slot - 1 : slot;
+            m[slot] = S( a );
+            double ea = interval_error( i, f );
+            m[slot] = S( b );
+            if( ea < interval_error( i, f ) ) m[slot] = S( a );
+        }
+        void build( const function &f ) {
+            const double step = 1.0 / (slots_ - 1), h = step / 64;
+            v.resize( slots_ );
+            for( unsigned i = 0; i < slots_; ++i ) {
+                v[i] = S( f( i * step ) );
+            }
+            if( mode_ == LUT_HERMITE ) {
+                m.resize( slots_ );
+                for( unsigned i = 1; i + 1 < slots_; ++i ) {
+                    m[i] = S( (f( i * step + h ) - f( i * step - h )) / (h + h) * step );
+                }
+                // endpoints: EXPOIN jumps at 0 and CIRC* have infinite slopes at the
+                // borders, so try a one-sided slope and the secant; keep the best fit.
+                // the one-sided slope differentiates a quadratic through 3 inner points.
+                auto slope = [&]( double x, double dir ) {
+                    return dir * (-5 * f( x + dir * h ) + 8 * f( x + 2 * dir * h ) - 3 * f( x + 3 * dir * h )) / (h + h) * step;
+                };
+                fit( 0, slope( 0, +1 ), v[1] - v[0], f );
+                fit( slots_-1, slope( 1, -1 ), v[slots_-1] - v[slots_-2], f );
+            }
+            for( unsigned i = 0; i + 1 < slots_; ++i ) {
+                double e = interval_error( i, f );
+                error_ = e > error_ ? e : error_;
+                // nearest steps at the midpoint: the samples only see one side of it
+                if( mode_ == LUT_NEAREST ) {
+                    double mid = f( (i + 0.5) * step ), a = std::abs( v[i] - mid ), b = std::abs( v[i+1] - mid );
+                    e = a > b ? a : b;
+                    error_ = e > error_ ? e : error_;
+                }
+            }
+        }
+
+    public:
+
+        basic_lut( int type = TYPE::LINEAR, unsigned slots = 256, int mode = LUT_LINEAR ) :
+            type_(unsigned(type) < TOTAL || detail::find_curve( type ) ? type : int(TYPE::LINEAR)), mode_(mode), slots_(slots < 2 ? 2 : slots), error_(0) {
+            const int curve = type_;
+            build( [curve]( double t ) { return tween::ease( curve, t ); } );
+        }
+        // any f(dt01), e.g. a composed expr; type() is UNDEFINED
+        basic_lut( const function &f, unsigned slots = 256, int mode = LUT_LINEAR ) :
+            type_(TYPE::UNDEFINED), mode_(mode), slots_(slots < 2 ? 2 : slots), error_(0) {
+            build( f );
+        }
+
+        double operator()( double t ) const {
+            t = t < 0 ? 0 : t > 1 ? 1 : t;
+            double x = t * (slots_ - 1);
+            if( mode_ == LUT_NEAREST ) {
+                return v[ unsigned(x + 0.5) ];
+            }
+            unsigned i = unsigned(x) < slots_ - 2 ? unsigned(x) : slots_ - 2;
+            double f = x - i;
+            if( mode_ == LUT_HERMITE ) {
+                double f2 = f * f, f3 = f2 * f;
+                return (2*f3 - 3*f2 + 1) * v[i] + (f3 - 2*f2 + f) * m[i] + (-2*f3 + 3*f2) * v[i+1] + (f3 - f2) * m[i+1];
+            }
+            return v[i] + (v[i+1] - v[i]) * f;
+        }
+
+        int type() const { return type_; }
+        int mode() const { return mode_; }
+        unsigned slots() const { return slots_; }
+        size_t bytes() const { return (v.size() + m.size()) * sizeof(S); }
+        double max_error() const { return error_; }
+    };
+
+    typedef basic_lut<float> lut;
+
+    // parametric curves, solved once at construction: both keep a memo table
+    // (nearest lookup, like ease(,,true)) next to their exact evaluation.
+
+    // css cubic-bezier(x1,y1,x2,y2): end points (0,0) and (1,1); x1, x2 are
+    // clamped to [0,1] so x(t) stays monotonic. construction tabulates t at
+    // uniform x; each lookup brackets t there and refines it with newton's method,
+    // falling back to bisection on flat slopes.
+    class bezier {
+        enum { SEEDS = 64, MEMO = 256 };
+        double ax, bx, cx, ay, by, cy;  // x(t) = ((ax*t + bx)*t + cx)*t, same for y
+        double seed[SEEDS + 1];         // t such that x(t) = i / SEEDS
+        float memo[MEMO];
+
+        double x( double t ) const { return ((ax * t + bx) * t + cx) * t; }
+        double y( double t ) const { return ((ay * t + by) * t + cy) * t; }
+        double dx( double t ) const { return (3 * ax * t + 2 * bx) * t + cx; }
+
+        double bisect( double px, double lo, double hi ) const {
+            for( int k = 0; k < 64 && hi - lo > 1e-15; ++k ) {
+                double t = 0.5 * (lo + hi);
+                (x( t ) < px ? lo : hi) = t;
+            }
+            return 0.5 * (lo + hi);
+        }
+        double solve( double px ) const {
+            double f = px * double(SEEDS);
+            int i = int(f) < SEEDS ? int(f) : SEEDS - 1;
+            double lo = seed[i], hi = seed[i + 1], t = lo + (f - i) * (hi - lo);
+            for( int k = 0; k < 6; ++k ) {
+                double e = x( t ) - px, d = dx( t );
+                if( std::abs( e ) < 1e-14 ) return t;
+                (e < 0 ? lo : hi) = t;
+                if( d < 1e-9 ) break;
+                t -= e / d;
+                if( !(lo < t && t < hi) ) break;
+            }
+            return bisect( px, lo, hi );
+        }
+
+    public:
+
+        bezier( double x1 = 0, double y1 = 0, double x2 = 1, double y2 = 1 ) {
+            x1 = x1 < 0 ? 0 : x1 > 1 ? 1 : x1;
+            x2 = x2 < 0 ? 0 : x2 > 1 ? 1 : x2;
+            cx = 3 * x1, bx = 3 * (x2 - x1) - cx, ax = 1 - cx - bx;
+            cy = 3 * y1, by = 3 * (y2 - y1) - cy, ay = 1 - cy - by;
+            seed[0] = 0, seed[SEEDS] = 1;
+            for( int i = 1; i < SEEDS; ++i ) {
+                seed[i] = bisect( double(i) / double(SEEDS), seed[i - 1], 1 );
+            }
+            for( int i = 0; i < MEMO; ++i ) {
+                memo[i] = float( (*this)( double(i) / (MEMO - 1) ) );
+            }
+        }
+
+        double operator()( double dt01, bool memoized = false ) const {
+            dt01 = dt01 < 0 ? 0 : dt01 > 1 ? 1 : dt01;
+            if( memoized ) return memo[ int(dt01 * (MEMO - 1)) ];
+            return dt01 <= 0 || dt01 >= 1 ? dt01 : y( solve( dt01 ) );
+        }
+        void operator()( const float *dt01, float *out, size_t n, bool memoized = false ) const {
+            for( size_t i = 0; i < n; ++i ) {
+                out[i] = float( (*this)( dt01[i], memoized ) );
+            }
+        }
+    };
+
+    // monotone cubic spline through (x,y) points: fritsch-carlson tangents, so no
+    // overshoot between points. points are sorted by x (repeated x keep the first);
+    // (0,0) and (1,1) are added when the first/last x are inside (0,1).
+    class spline {
+        enum { MEMO = 256 };
+        std::vector<double> xs, ys, ms;
+        float memo[MEMO];
+
+    public:
+
+        // xy: interleaved x,y pairs
+        spline( const double *xy = 0, size_t points = 0 ) {
+            std::vector< std::pair<double, double> > p;
+            for( size_t i = 0; i < points; ++i ) {
+                p.push_back( std::make_pair( xy[i*2], xy[i*2+1] ) );
+            }
+            std::sort( p.begin(), p.end() );
+            if( p.empty() || p.front().first > 0 ) p.insert( p.begin(), std::make_pair( 0.0, 0.0 ) );
+            if( p.back().first < 1 ) p.push_back( std::make_pair( 1.0, 1.0 ) );
+            for( size_t i = 0; i < p.size(); ++i ) {
+                if( xs.empty() || p[i].first > xs.back() ) xs.push_back( p[i].first ), ys.push_back( p[i].second );
+            }
+            const size_t n = xs.size();
+            std::vector<double> d( n - 1 );
+            for( size_t k = 0; k + 1 < n; ++k ) {
+                d[k] = (ys[k+1] - ys[k]) / (xs[k+1] - xs[k]);
+            }
+            ms.assign( n, 0.0 );
+            ms[0] = d[0], ms[n-1] = d[n-2];
+            for( size_t k = 1; k + 1 < n; ++k ) {
+                ms[k] = d[k-1] * d[k] > 0 ? 0.5 * (d[k-1] + d[k]) : 0;
+            }
+            for( size_t k = 0; k + 1 < n; ++k ) {
+                if( d[k] == 0 ) { ms[k] = ms[k+1] = 0; continue; }
+                double a = ms[k] / d[k], b = ms[k+1] / d[k], r = a * a + b * b;
+                if( r > 9 ) {
+                    double tau = 3 / std::sqrt( r );
+                    ms[k] = tau * a * d[k], ms[k+1] = tau * b * d[k];
+                }
+            }
+            for( int i = 0; i < MEMO; ++i ) {
+                memo[i] = float( (*this)( double(i) / (MEMO - 1) ) );
+            }
+        }
+
+        double operator()( double dt01, bool memoized = false ) const {
+            dt01 = dt01 < 0 ? 0 : dt01 > 1 ? 1 : dt01;
+            if( memoized ) return memo[ int(dt01 * (MEMO - 1)) ];
+            size_t k = size_t( std::upper_bound( xs.begin(), xs.end() - 1, dt01 ) - xs.begin() );
+            k = k ? k - 1 : 0;
+            double h = xs[k+1] - xs[k], s = (dt01 - xs[k]) / h, s2 = s * s, s3 = s2 * s;
+            return (2*s3 - 3*s2 + 1) * ys[k] + (s3 - 2*s2 + s) * h * ms[k] + (-2*s3 + 3*s2) * ys[k+1] + (s3 - s2) * h * ms[k+1];
+        }
+        void operator()( const float *dt01, float *out, size_t n, bool memoized = false ) const {
+            for( size_t i = 0; i < n; ++i ) {
+                out[i] = float( (*this)( dt01[i], memoized ) );
+            }
+        }
+    };
+
+    // batch evaluation
+
+    namespace detail {
+        template<int TYPE, typename T, typename MATH = exact_math>
+        static inline void batch( const T *t, T *out, size_t n, size_t i = 0 ) {
+            typedef lane<MATH, T> L;
+            for( ; i < n; ++i ) {
+                out[i] = L::get( curve<TYPE>::eval( typename L::type( vmin( vmax( t[i], T(0) ), T(1) ) ) ) );
+            }
+        }
+
+        template<int TYPE, typename MATH>
+        static inline void batch( const float *t, float *out, size_t n ) {
+            size_t i = 0;
+#           if tween$avx2
+            typedef lane<MATH, f32x8> L8;
+            for( ; i + 8 <= n; i += 8 ) {
+                f32x8 p = vmin( vmax( f32x8( _mm256_loadu_ps( t + i ) ), 0.0 ), 1.0 );
+                _mm256_storeu_ps( out + i, L8::get( curve<TYPE>::eval( typename L8::type( p ) ) ).v );
+            }
+#           endif
+#           if tween$sse2
+            typedef lane<MATH, f32x4> L4;
+            for( ; i + 4 <= n; i += 4 ) {
+                f32x4 p = vmin( vmax( f32x4( _mm_loadu_ps( t + i ) ), 0.0 ), 1.0 );
+                _mm_storeu_ps( out + i, L4::get( curve<TYPE>::eval( typename L4::type( p ) ) ).v );
+            }
+#           endif
+            batch<TYPE, float, MATH>( t, out, n, i );
+        }
+
+        template<typename T>
+        static inline bool batch_custom( int type, const T *t, T *out, size_t n ) {
+            const custom_curve *c = find_curve( type );
+            for( size_t i = 0; c && i < n; ++i ) {
+                out[i] = T( c->fn( t[i] < 0 ? 0 : t[i] > 1 ? 1 : double(t[i]) ) );
+            }
+            return c != 0;
+        }
+    }
+
+    static inline
+    void ease( int type, const float *dt01, float *out, size_t n, int wrap = WRAP_CLAMP ) {
+        if( wrap != WRAP_CLAMP ) {
+            return detail::wrap_blocks( wrap, dt01, out, n, [type]( const float *t, float *o, size_t m ) { ease( type, t, o, m ); } );
+        }
+        tween$stats_batch( type, n );
+#   define $tween( unused, type ) case TYPE::type: return detail::batch<TYPE::type, exact_math>( dt01, out, n );
+        switch( type ) {
+            default: if( detail::batch_custom( type, dt01, out, n ) ) return;
+                     return detail::batch<TYPE::LINEAR, exact_math>( dt01, out, n );
+            $tween_xmacro(expand cases)
+        }
+#   undef $tween
+    }
+
+    static inline
+    void ease( int type, const double *dt01, double *out, size_t n, int wrap = WRAP_CLAMP ) {
+        if( wrap != WRAP_CLAMP ) {
+            return detail::wrap_blocks( wrap, dt01, out, n, [type]( const double *t, double *o, size_t m ) { ease( type, t, o, m ); } );
+        }
+        tween$stats_batch( type, n );
+#   define $tween( unused, type ) case TYPE::type: return detail::batch<TYPE::type, double>( dt01, out, n );
+        switch( type ) {
+            default: if( detail::batch_custom( type, dt01, out, n ) ) return;
+                     return detail::batch<TYPE::LINEAR, double>( dt01, out, n );
+            $tween_xmacro(expand cases)
+        }
+#   undef $tween
+    }
+
+    // fast_math evaluation, float only: scalars and sse2/avx2 lanes share the
+    // polynomials of detail::approx. only curves built on sin/cos/exp2/exp change
+    // (SINE*, EXPO*, ELASTIC*, EXPONENTIAL, SINESQUARE, SWING, SINPI2); the rest
+    // return the exact float results. ease_fast_error() measures the max abs error
+    // against ease(type,dt01): 7e-7 for SINE*/SINPI2/SWING, 3.3e-6 for EXPO* and
+    // ELASTIC*, 1.4e-6 for SINESQUARE, 1e-6 for EXPONENTIAL; the rest stay within
+    // the float rounding, 3.1e-6 at worst (BOUNCE*). test.cc checks these bounds.
+
+    static inline
+    void ease_fast( int type, const float *dt01, float *out, size_t n ) {
+        tween$stats_batch( type, n );
+#   define $tween( unused, type ) case TYPE::type: return detail::batch<TYPE::type, fast_math>( dt01, out, n );
+        switch( type ) {
+            default: if( detail::batch_custom( type, dt01, out, n ) ) return;
+                     return detail::batch<TYPE::LINEAR, fast_math>( dt01, out, n );
+            $tween_xmacro(expand cases)
+        }
+#   undef $tween
+    }
+
+    static inline
+    float ease_fast( int type, float dt01 ) {
+#   define $tween( unused, type ) case TYPE::type: return detail::batch<TYPE::type, float, fast_math>( &dt01, &dt01, 1 ), dt01;
+        switch( type ) {
+            default: dt01 = dt01 < 0 ? 0.f : dt01 > 1 ? 1.f : dt01;
+                     return detail::batch_custom( type, &dt01, &dt01, 1 ), dt01;
+            $tween_xmacro(expand cases)
+        }
+#   undef $tween
+    }
+
+    static inline
+    double ease_fast_error( int type ) {
+        double worst = 0;
+        for( unsigned i = 0; i <= 65536; ++i ) {
+            double t = i / 65536.0, e = std::abs( ease_fast( type, float(t) ) - tween::ease( type, double(float(t)) ) );
+            worst = e > worst ? e : worst;
+        }
+        return worst;
+    }
+
+    // derivatives with respect to dt01: velocity (order 1) and acceleration
+    // (order 2), analytic. the kernels run over detail::jet lanes, so every
+    // curve gets them exactly, in scalars and in sse2/avx2 batches alike.
+    // t is clamped like ease() does, hence derivatives are 0 outside [0,1];
+    // at 0 and 1, and at the joins of piecewise curves, they are one-sided.
+    // runtime curves have no kernel: central differences on their function.
+
+    namespace detail {
+        template<int TYPE, typename V>
+        static inline jet<V> derive( V t ) {
+            // selected, not scaled, to 0 outside: CIRC* slopes are infinite at the
+            // clamped ends, and 0 * inf would leak NaNs
+            V p = vmin( vmax( t, V(0) ), V(1) );
+            jet<V> j = curve<TYPE>::eval( jet<V>( p, V(1), V(0) ) );
+            return jet<V>( j.v, vsel( veq( p, t ), j.d1, V(0) ), vsel( veq( p, t ), j.d2, V(0) ) );
+        }
+
+        template<int TYPE, typename T>
+        static inline void derive( const T *t, T *v, T *d1, T *d2, size_t n, size_t i ) {
+            for( ; i < n; ++i ) {
+                jet<T> j = derive<TYPE>( t[i] );
+                if( v ) v[i] = j.v;
+                if( d1 ) d1[i] = j.d1;
+                if( d2 ) d2[i] = j.d2;
+            }
+        }
+
+        template<int TYPE>
+        static inline void derive( const float *t, float *v, float *d1, float *d2, size_t n ) {
+            size_t i = 0;
+#           if tween$avx2
+            for( ; i + 8 <= n; i += 8 ) {
+                jet<f32x8> j = derive<TYPE>( f32x8( _mm256_loadu_ps( t + i ) ) );
+                if( v ) _mm256_storeu_ps( v + i, j.v.v );
+                if( d1 ) _mm256_storeu_ps( d1 + i, j.d1.v );
+                if( d2 ) _mm256_storeu_ps( d2 + i, j.d2.v );
+            }
+#           endif
+#           if tween$sse2
+            for( ; i + 4 <= n; i += 4 ) {
+                jet<f32x4> j = derive<TYPE>( f32x4( _mm_loadu_ps( t + i ) ) );
+                if( v ) _mm_storeu_ps( v + i, j.v.v );
+                if( d1 ) _mm_storeu_ps( d1 + i, j.d1.v );
+                if( d2 ) _mm_storeu_ps( d2 + i, j.d2.v );
+            }
+#           endif
+            derive<TYPE, float>( t, v, d1, d2, n, i );
+        }
+
+        static inline bool derive_custom( int type, double t, double &v, double &d1, double &d2 ) {
+            const custom_curve *c = find_curve( type );
+            if( !c ) {
+                return false;
+            }
+            const double h = 1e-4, p = t < 0 ? 0 : t > 1 ? 1 : t, m = p < h ? h : p > 1 - h ? 1 - h : p;
+            double lo = c->fn( m - h ), mid = c->fn( m ), hi = c->fn( m + h ), inside = p == t ? 1 : 0;
+            v = p == m ? mid : c->fn( p );
+            d1 = inside * (hi - lo) / (2 * h);
+            d2 = inside * (hi - 2 * mid + lo) / (h * h);
+            return true;
+        }
+        static inline bool derive_custom( int type, const float *t, float *v, float *d1, float *d2, size_t n ) {
+            double jv, j1, j2;
+            if( !find_curve( type ) ) {
+                return false;
+            }
+            for( size_t i = 0; i < n; ++i ) {
+                derive_custom( type, t[i], jv, j1, j2 );
+                if( v ) v[i] = float( jv );
+                if( d1 ) d1[i] = float( j1 );
+                if( d2 ) d2[i] = float( j2 );
+            }
+            return true;
+        }
+    }
+
+    static inline
+    double ease_derivatives( int type, double dt01, double &velocity, double &acceleration ) {
+        detail::jet<double> j;
+#   define $tween( unused, type ) case TYPE::type: j = detail::derive<TYPE::type>( dt01 ); break;
+        switch( type ) {
+            default: {
+                double v;
+                if( detail::derive_custom( type, dt01, v, velocity, acceleration ) ) return v;
+                j = detail::derive<TYPE::LINEAR>( dt01 );
+            }
+            break;
+            $tween_xmacro(expand cases)
+        }
+#   undef $tween
+        velocity = j.d1, acceleration = j.d2;
+        return j.v;
+    }
+
+    static inline
+    double ease_derivative( int type, double dt01, int order = 1 ) {
+        double v, d1, d2;
+        v = ease_derivatives( type, dt01, d1, d2 );
+        return order == 0 ? v : order == 1 ? d1 : order == 2 ? d2 : NAN;
+    }
+
+    // batch: null outputs are skipped
+    static inline
+    void ease_derivatives( int type, const float *dt01, float *value, float *velocity, float *acceleration, size_t n ) {
+#   define $tween( unused, type ) case TYPE::type: return detail::derive<TYPE::type>( dt01, value, velocity, acceleration, n );
+        switch( type ) {
+            default: if( detail::derive_custom( type, dt01, value, velocity, acceleration, n ) ) return;
+                     return detail::derive<TYPE::LINEAR>( dt01, value, velocity, acceleration, n );
+            $tween_xmacro(expand cases)
+        }
+#   undef $tween
+    }
+
+    static inline
+    void ease_derivative( int type, const float *dt01, float *out, size_t n, int order = 1 ) {
+        if( order == 0 ) {
+            return ease( type, dt01, out, n );
+        }
+        if( order == 1 || order == 2 ) {
+            return ease_derivatives( type, dt01, 0, order == 1 ? out : 0, order == 2 ? out : 0, n );
+        }
+        std::fill( out, out + n, float( NAN ) );
+    }
+
+    // composition: expr builds an expression out of curves (any id, registered
+    // ones too) and operators, flattened into one postfix program. nest() binds
+    // the inner result as t for the outer expression; in/out/inout and the
+    // ping/pong family remap t (and the result) the same way their double
+    // versions do. batches run the program over blocks, each curve as a single
+    // batch ease(). bake() fuses the whole program into one interpolated table.
+
+    class expr {
+        enum OPCODE { T, CONST, CURVE, ADD, SUB, MUL, BIND, UNBIND, PONG, PINGPONG, INOUT_ARG, INOUT_RES, ONE_MINUS };
+        struct op {
+            int code, type;
+            double k;
+        };
+        enum { STACK = 16, BLOCK = 64 };
+        std::vector<op> code;
+        int depth;   // max value stack, then max nesting of bound t's
+        int binds;
+        std::shared_ptr< const lut > table;
+
+        expr( const expr &a, const expr &b, int code_ ) : code(a.code), depth(std::max( a.depth, b.depth + 1 )), binds(std::max( a.binds, b.binds )) {
+            code.insert( code.end(), b.code.begin(), b.code.end() );
+            push( code_ );
+        }
+        expr &push( int code_, int type = 0, double k = 0 ) {
+            op o = { code_, type, k };
+            code.push_back( o );
+            return *this;
+        }
+        // wraps e with t remapped by ARG and the result by RES (or none)
+        static expr remap( const expr &e, int arg, int res = -1 ) {
+            expr r;
+            r.code.clear();
+            r.push( arg ).push( BIND );
+            r.code.insert( r.code.end(), e.code.begin(), e.code.end() );
+            r.push( UNBIND );
+            if( res >= 0 ) r.push( res );
+            r.depth = std::max( e.depth, 1 ), r.binds = e.binds + 1;
+            return r;
+        }
+
+        double run( double t ) const {
+            double fixed[2 * STACK];
+            std::vector<double> heap;
+            double *stack = fixed, *ts = fixed + STACK;
+            if( depth > STACK || binds > STACK ) {
+                heap.resize( depth + binds + 1 ), stack = &heap[0], ts = stack + depth;
+            }
+            int sp = 0, tp = 0;
+            for( size_t i = 0, n = code.size(); i < n; ++i ) {
+                const op &o = code[i];
+                switch( o.code ) {
+                    default:
+                    break; case T:         stack[sp++] = t;
+                    break; case CONST:     stack[sp++] = o.k;
+                    break; case CURVE:     stack[sp-1] = tween::ease( o.type, stack[sp-1] );
+                    break; case ADD:       --sp, stack[sp-1] += stack[sp];
+                    break; case SUB:       --sp, stack[sp-1] -= stack[sp];
+                    break; case MUL:       --sp, stack[sp-1] *= stack[sp];
+                    break; case BIND:      ts[tp++] = t, t = stack[--sp];
+                    break; case UNBIND:    t = ts[--tp];
+                    break; case PONG:      stack[sp++] = 1 - t;
+                    break; case PINGPONG:  stack[sp++] = t < 0.5 ? t + t : 2 - t - t;
+                    break; case INOUT_ARG: stack[sp++] = t < 0.5 ? t + t : 2 - t - t;
+                    break; case INOUT_RES: stack[sp-1] = t < 0.5 ? stack[sp-1] * 0.5 : 1 - stack[sp-1] * 0.5;
+                    break; case ONE_MINUS: stack[sp-1] = 1 - stack[sp-1];
+                }
+            }
+            return stack[0];
+        }
+        void run( const float *t0, float *out, size_t n ) const {
+            typedef float row[BLOCK];
+            row fixed[2 * STACK], t;
+            std::vector<float> heap;
+            row *stack = fixed, *ts = fixed + STACK;
+            if( depth > STACK || binds > STACK ) {
+                heap.resize( (depth + binds + 1) * BLOCK ), stack = reinterpret_cast<row *>( &heap[0] ), ts = stack + depth;
+            }
+            int sp = 0, tp = 0;
+            std::memcpy( t, t0, n * sizeof(float) );
+            for( size_t i = 0, ops = code.size(); i < ops; ++i ) {
+                const op &o = code[i];
+                float *top = stack[sp ? sp - 1 : 0], *next = stack[sp];
+                switch( o.code ) {
+                    default:
+                    break; case T:         std::memcpy( next, t, n * sizeof(float) ), ++sp;
+                    break; case CONST:     std::fill( next, next + n, float(o.k) ), ++sp;
+                    break; case CURVE:     tween::ease( o.type, top, top, n );
+                    break; case ADD:       --sp; for( size_t j = 0; j < n; ++j ) stack[sp-1][j] += stack[sp][j];
+                    break; case SUB:       --sp; for( size_t j = 0; j < n; ++j ) stack[sp-1][j] -= stack[sp][j];
+                    break; case MUL:       --sp; for( size_t j = 0; j < n; ++j ) stack[sp-1][j] *= stack[sp][j];
+                    break; case BIND:      std::memcpy( ts[tp++], t, n * sizeof(float) ), std::memcpy( t, stack[--sp], n * sizeof(float) );
+                    break; case UNBIND:    std::memcpy( t, ts[--tp], n * sizeof(float) );
+                    break; case PONG:      for( size_t j = 0; j < n; ++j ) next[j] = 1 - t[j]; ++sp;
+                    break; case PINGPONG:
+                           case INOUT_ARG: for( size_t j = 0; j < n; ++j ) next[j] = t[j] < 0.5f ? t[j] + t[j] : 2 - t[j] - t[j]; ++sp;
+                    break; case INOUT_RES: for( size_t j = 0; j < n; ++j ) top[j] = t[j] < 0.5f ? top[j] * 0.5f : 1 - top[j] * 0.5f;
+                    break; case ONE_MINUS: for( size_t j = 0; j < n; ++j ) top[j] = 1 - top[j];
+                }
+            }
+            std::memcpy( out, stack[0], n * sizeof(float) );
+        }
+
+    public:
+
+        explicit expr( int type = TYPE::LINEAR ) : depth(1), binds(0) {
+            push( T ).push( CURVE, type );
+        }
+        static expr constant( double k ) {
+            expr e;
+            e.code.clear();
+            e.push( CONST, 0, k );
+            return e;
+        }
+
+        friend expr operator+( const expr &a, const expr &b ) { return expr( a, b, ADD ); }
+        friend expr operator-( const expr &a, const expr &b ) { return expr( a, b, SUB ); }
+        friend expr operator*( const expr &a, const expr &b ) { return expr( a, b, MUL ); }
+
+        friend expr nest( const expr &outer, const expr &inner );
+        friend expr in( const expr &e );
+        friend expr out( const expr &e );
+        friend expr inout( const expr &e );
+        friend expr pong( const expr &e );
+        friend expr pingpong( const expr &e );
+        friend expr pongping( const expr &e );
+
+        // fuses the program into one table; combining baked exprs combines programs
+        expr &bake( unsigned slots = 256, int mode = LUT_HERMITE ) {
+            expr program( *this );
+            program.table.reset();
+            table = std::make_shared< const lut >( [program]( double t ) { return program( t ); }, slots, mode );
+            return *this;
+        }
+        bool baked() const { return table != nullptr; }
+        double max_error() const { return table ? table->max_error() : 0; }
+
+        double operator()( double dt01 ) const {
+            dt01 = dt01 < 0 ? 0 : dt01 > 1 ? 1 : dt01;
+            return table ? (*table)( dt01 ) : run( dt01 );
+        }
+        void operator()( const float *dt01, float *out, size_t n ) const {
+            for( size_t i = 0; i < n; i += BLOCK ) {
+                size_t m = n - i < size_t(BLOCK) ? n - i : size_t(BLOCK);
+                float t[BLOCK];
+                for( size_t j = 0; j < m; ++j ) t[j] = dt01[i+j] < 0 ? 0.f : dt01[i+j] > 1 ? 1.f : dt01[i+j];
+                if( table ) for( size_t j = 0; j < m; ++j ) out[i+j] = float( (*table)( t[j] ) );
+                else run( t, out + i, m );
+            }
+        }
+    };
+
+    // outer( inner( t ) )
+    inline expr nest( const expr &outer, const expr &inner ) {
+        expr r( inner );
+        r.table.reset();
+        r.push( expr::BIND );
+        r.code.insert( r.code.end(), outer.code.begin(), outer.code.end() );
+        r.push( expr::UNBIND );
+        r.depth = std::max( inner.depth, outer.depth ), r.binds = std::max( inner.binds, outer.binds + 1 );
+        return r;
+    }
+    inline expr in( const expr &e ) { expr r( e ); r.table.reset(); return r; }
+    inline expr out( const expr &e ) { return expr::remap( e, expr::PONG, expr::ONE_MINUS ); }
+    inline expr inout( const expr &e ) { return expr::remap( e, expr::INOUT_ARG, expr::INOUT_RES ); }
+    inline expr ping( const expr &e ) { return in( e ); }
+    inline expr pong( const expr &e ) { return expr::remap( e, expr::PONG ); }
+    inline expr pingpong( const expr &e ) { return expr::remap( e, expr::PINGPONG ); }
+    inline expr pongping( const expr &e ) { return expr::remap( expr::remap( e, expr::PONG ), expr::PINGPONG ); }
+
+    // tuner: measures every evaluation strategy per curve on this machine and
+    // dispatches each curve to the fastest one within the error tolerance (max
+    // abs error vs ease(type,dt01)). luts try 64..4096 slots and keep the
+    // smallest that fits. save() returns a text config; load() restores it
+    // without measuring again.
+
+    enum STRATEGY
+    {
+        EVAL_EXACT,        // ease( type, dt01 )
+        EVAL_FLOAT,        // ease<float>( type, dt01 )
+        EVAL_MEMOIZED,     // ease( type, dt01, true )
+        EVAL_LUT_LINEAR,   // lut( type, slots, LUT_LINEAR )
+        EVAL_LUT_HERMITE,  // lut( type, slots, LUT_HERMITE )
+        EVAL_FAST,         // ease_fast( type, dt01 )
+        EVAL_TOTAL
+    };
+
+    class tuner {
+        struct entry {
+            int strategy;
+            unsigned slots;
+            double error, ns;
+        };
+        entry table[TOTAL];
+        lut luts[TOTAL];
+        double tolerance_;
+
+        static const char *name( int strategy ) {
+            static const char *names[EVAL_TOTAL] = { "exact", "float", "memoized", "lut_linear", "lut_hermite", "fast" };
+            return names[ strategy ];
+        }
+        double eval( int strategy, int type, double t ) const {
+            switch( strategy ) {
+                default: return tween::ease( type, t );
+                case EVAL_FLOAT: return tween::ease<float>( type, float(t) );
+                case EVAL_MEMOIZED: return tween::ease( type, t, true );
+                case EVAL_LUT_LINEAR: case EVAL_LUT_HERMITE: return luts[type]( t );
+                case EVAL_FAST: return tween::ease_fast( type, float(t) );
+            }
+        }
+        double measure_error( int strategy, int type ) const {
+            double e = 0;
+            for( unsigned i = 0; i <= 8192; ++i ) {
+                double t = i / 8192.0, d = std::abs( eval( strategy, type, t ) - tween::ease( type, t ) );
+                e = d > e ? d : e;
+            }
+            return e;
+        }
+        double measure_ns( int strategy, int type ) const {
+            enum { N = 2048, RUNS = 5 };
+            double best = 1e30, sum = 0;
+            for( int r = 0; r < RUNS; ++r ) {
+                std::chrono::steady_clock::time_point a = std::chrono::steady_clock::now();
+                for( unsigned i = 0, x = 12345; i < N; ++i ) {
+                    x = x * 1664525u + 1013904223u;  // lcg: unpredictable, cheap inputs
+                    sum += eval( strategy, type, (x >> 8) * (1.0 / 16777215) );
+                }
+                double d = std::chrono::duration<double, std::nano>( std::chrono::steady_clock::now() - a ).count() / double(N);
+                best = d < best ? d : best;
+            }
+            volatile double sink = sum;
+            (void)sink;
+            return best;
+        }
+        bool fits_lut( int type, int mode, unsigned &slots ) {
+            for( slots = 64; slots <= 4096; slots *= 4 ) {
+                luts[type] = lut( type, slots, mode );
+                if( luts[type].max_error() <= tolerance_ ) return true;
+            }
+            return false;
+        }
+
+    public:
+
+        explicit tuner( double tolerance = 1e-4, bool measure = true ) : tolerance_(tolerance) {
+            for( int type = 0; type < TOTAL; ++type ) {
+                entry best = { EVAL_EXACT, 0, 0, measure ? measure_ns( EVAL_EXACT, type ) : 0 };
+                for( int s = EVAL_FLOAT; measure && s < EVAL_TOTAL; ++s ) {
+                    entry e = { s, 0, 0, 0 };
+                    if( s == EVAL_LUT_LINEAR || s == EVAL_LUT_HERMITE ) {
+                        if( !fits_lut( type, s == EVAL_LUT_LINEAR ? LUT_LINEAR : LUT_HERMITE, e.slots ) ) continue;
+                    }
+                    if( (e.error = measure_error( s, type )) > tolerance_ ) continue;
+                    if( (e.ns = measure_ns( s, type )) < best.ns ) best = e;
+                }
+                table[type] = best;
+                if( best.slots ) luts[type] = lut( type, best.slots, best.strategy == EVAL_LUT_LINEAR ? LUT_LINEAR : LUT_HERMITE );
+            }
+        }
+
+        double operator()( int type, double dt01 ) const {
+            return unsigned(type) < TOTAL ? eval( table[type].strategy, type, dt01 ) : tween::ease( type, dt01 );
+        }
+
+        int strategy( int type ) const { return unsigned(type) < TOTAL ? table[type].strategy : int(EVAL_EXACT); }
+        unsigned slots( int type ) const { return unsigned(type) < TOTAL ? table[type].slots : 0; }
+        double error( int type ) const { return unsigned(type) < TOTAL ? table[type].error : 0; }
+        double ns( int type ) const { return unsigned(type) < TOTAL ? table[type].ns : 0; }
+        double tolerance() const { return tolerance_; }
+
+        // one line per curve: name strategy slots error ns
+        std::string save() const {
+            char line[128];
+            std::snprintf( line, sizeof(line), "tween-tuner 1 %.17g\n", tolerance_ );
+            std::string out = line;
+            for( int type = 0; type < TOTAL; ++type ) {
+                const entry &e = table[type];
+                std::snprintf( line, sizeof(line), "%s %s %u %.9g %.9g\n", nameof( type ), name( e.strategy ), e.slots, e.error, e.ns );
+                out += line;
+            }
+            return out;
+        }
+        // false (and unchanged) on malformed input or unknown names
+        bool load( const std::string &text ) {
+            entry parsed[TOTAL];
+            double tolerance;
+            int version, at = 0;
+            if( std::sscanf( text.c_str(), "tween-tuner %d %lg\n%n", &version, &tolerance, &at ) != 2 || version != 1 || !at ) return false;
+            for( int type = 0; type < TOTAL; ++type ) {
+                char curve[32], strategy[32];
+                int used = 0;
+                entry &e = parsed[type];
+                if( std::sscanf( text.c_str() + at, "%31s %31s %u %lg %lg\n%n", curve, strategy, &e.slots, &e.error, &e.ns, &used ) != 5 || !used ) return false;
+                if( std::strcmp( curve, nameof( type ) ) ) return false;
+                for( e.strategy = 0; e.strategy < EVAL_TOTAL && std::strcmp( strategy, name( e.strategy ) ); ++e.strategy ) {}
+                if( e.strategy == EVAL_TOTAL ) return false;
+                bool is_lut = e.strategy == EVAL_LUT_LINEAR || e.strategy == EVAL_LUT_HERMITE;
+                if( is_lut != (e.slots >= 2 && e.slots <= 65536) || (!is_lut && e.slots) ) return false;
+                at += used;
+            }
+            tolerance_ = tolerance;
+            for( int type = 0; type < TOTAL; ++type ) {
+                const entry &e = table[type] = parsed[type];
+                luts[type] = e.slots ? lut( type, e.slots, e.strategy == EVAL_LUT_LINEAR ? LUT_LINEAR : LUT_HERMITE ) : lut();
+            }
+            return true;
+        }
+    };
+
+    // pool: structure-of-arrays tween storage, bucketed by curve. update(dt)
+    // advances every tween and evaluates each bucket with one batch ease() call.
+    // handles are a recycled slot (low 24 bits) and the slot's generation (high
+    // 8 bits), so a removed handle stays dead until its slot wraps 256 reuses.
+
+    class pool {
+        struct bucket {
+            std::vector<float> start, delta, duration, elapsed, t, value;
+            std::vector<unsigned> ids;
+        };
+        struct slot {
+            int type;
+            unsigned index;
+            unsigned generation;
+            bool live;
+        };
+        enum { SLOT_BITS = 24, SLOT_MASK = (1u << SLOT_BITS) - 1, GENERATION_MASK = 0xFF };
+        bucket buckets[TOTAL];
+        std::vector<slot> slots;
+        std::vector<unsigned> freed;
+        size_t count;
+
+    public:
+
+        pool() : count(0) {}
+
+        // ~0u when full (2^24 - 1 tweens): more slots would alias the generation bits
+        unsigned add( int type, float start, float end, float duration ) {
+            type = unsigned(type) < TOTAL ? type : int(TYPE::LINEAR);
+            bucket &b = buckets[type];
+            unsigned k;
+            if( !freed.empty() ) {
+                k = freed.back();
+                freed.pop_back();
+            } else if( slots.size() < SLOT_MASK ) {
+                k = unsigned( slots.size() );
+                slots.push_back( slot() );
+                slots[k].generation = 0;
+            } else {
+                return ~0u;
+            }
+            slots[k].type = type;
+            slots[k].index = unsigned( b.ids.size() );
+            slots[k].live = true;
+            const unsigned id = k | slots[k].generation << SLOT_BITS;
+            b.start.push_back( start );
+            b.delta.push_back( end - start );
+            b.duration.push_back( duration );
+            b.elapsed.push_back( 0 );
+            b.t.push_back( duration > 0 ? 0.f : 1.f );
+            b.value.push_back( duration > 0 ? start : end );
+            b.ids.push_back( id );
+            ++count;
+            return id;
+        }
+
+        // false for ids not alive: unknown, removed, or of a recycled slot
+        bool remove( unsigned id ) {
+            if( !live( id ) ) {
+                return false;
+            }
+            slot &s = slots[id & SLOT_MASK];
+            bucket &b = buckets[s.type];
+            unsigned last = unsigned( b.ids.size() - 1 );
+            if( s.index != last ) {
+                b.start[s.index] = b.start[last];
+                b.delta[s.index] = b.delta[last];
+                b.duration[s.index] = b.duration[last];
+                b.elapsed[s.index] = b.elapsed[last];
+                b.t[s.index] = b.t[last];
+                b.value[s.index] = b.value[last];
+                b.ids[s.index] = b.ids[last];
+                slots[ b.ids[last] & SLOT_MASK ].index = s.index;
+            }
+            b.start.pop_back(); b.delta.pop_back(); b.duration.pop_back();
+            b.elapsed.pop_back(); b.t.pop_back(); b.value.pop_back(); b.ids.pop_back();
+            s.live = false;
+            s.generation = (s.generation + 1) & GENERATION_MASK;
+            freed.push_back( id & SLOT_MASK );
+            --count;
+            return true;
+        }
+
+        void update( float dt ) {
+            for( int type = 0; type < TOTAL; ++type ) {
+                bucket &b = buckets[type];
+                const size_t n = b.ids.size();
+                if( !n ) continue;
+                float *el = &b.elapsed[0], *t = &b.t[0], *v = &b.value[0];
+                const float *s = &b.start[0], *d = &b.delta[0], *du = &b.duration[0];
+                for( size_t i = 0; i < n; ++i ) {
+                    el[i] += dt;
+                    t[i] = el[i] < du[i] ? el[i] / du[i] : 1.f;
+                }
+                tween::ease( type, t, v, n );
+                for( size_t i = 0; i < n; ++i ) {
+                    v[i] = s[i] + d[i] * v[i];
+                }
+            }
+        }
+
+        bool live( unsigned id ) const {
+            const unsigned k = id & SLOT_MASK;
+            return k < slots.size() && slots[k].live && slots[k].generation == id >> SLOT_BITS;
+        }
+        // ids not alive read 0
+        float value( unsigned id ) const {
+            if( !live( id ) ) return 0.f;
+            const slot &s = slots[id & SLOT_MASK];
+            return buckets[s.type].value[s.index];
+        }
+        float progress( unsigned id ) const {
+            if( !live( id ) ) return 0.f;
+            const slot &s = slots[id & SLOT_MASK];
+            return buckets[s.type].t[s.index];
+        }
+        bool done( unsigned id ) const {
+            return progress( id ) >= 1.f;
+        }
+        size_t size() const {
+            return count;
+        }
+
+        // bulk access, per curve bucket; order changes on remove(). types out of range: 0, null
+        size_t size( int type ) const { return unsigned(type) < TOTAL ? buckets[type].ids.size() : 0; }
+        const float *values( int type ) const { return unsigned(type) < TOTAL ? buckets[type].value.data() : 0; }
+        const unsigned *ids( int type ) const { return unsigned(type) < TOTAL ? buckets[type].ids.data() : 0; }
+    };
+
+    // arena: tween records behind generational handles. records are dense and
+    // structure-of-arrays, laid out as one contiguous segment per curve, so
+    // update(dt) is one pass over the records plus one batch ease() per segment.
+    // create() and cancel() shift at most one record per later non-empty
+    // segment: O(TOTAL) worst case, independent of the record count. freed
+    // slots are chained in an intrusive free list and bump their generation,
+    // so stale handles are rejected instead of aliasing a newer tween. storage
+    // only grows: no allocations while alive records stay within reserve(), or
+    // within the peak reached so far.
+
+    class arena {
+    public:
+        struct handle {
+            unsigned index, generation;  // generation 0: null handle
+
+            handle() : index(0), generation(0) {}
+            handle( unsigned index, unsigned generation ) : index(index), generation(generation) {}
+            bool operator==( const handle &other ) const { return index == other.index && generation == other.generation; }
+            bool operator!=( const handle &other ) const { return !operator==( other ); }
+        };
+
+    private:
+        struct slot {
+            unsigned generation;
+            unsigned index;  // dense record while alive, next free slot otherwise
+            int type;
+        };
+        enum { NONE = ~0u };
+
+        std::vector<float> start_, delta_, duration_, elapsed_, t_, value_;
+        std::vector<unsigned> owner_;
+        std::vector<slot> slots;
+        unsigned first[TOTAL + 1];  // segment of curve type: [first[type], first[type + 1])
+        unsigned free_head;
+
+        void move( unsigned from, unsigned to ) {
+            start_[to] = start_[from], delta_[to] = delta_[from], duration_[to] = duration_[from];
+            elapsed_[to] = elapsed_[from], t_[to] = t_[from], value_[to] = value_[from];
+            owner_[to] = owner_[from];
+            slots[ owner_[to] ].index = to;
+        }
+        void grow( size_t n ) {
+            start_.resize( n ), delta_.resize( n ), duration_.resize( n );
+            elapsed_.resize( n ), t_.resize( n ), value_.resize( n );
+            owner_.resize( n );
+        }
+        const slot *find( handle h ) const {
+            return h.index < slots.size() && h.generation && slots[h.index].generation == h.generation ? &slots[h.index] : 0;
+        }
+
+    public:
+
+        arena() : free_head( NONE ) {
+            for( int type = 0; type <= TOTAL; ++type ) first[type] = 0;
+        }
+
+        // warm-up: no allocations until more than n records are alive
+        void reserve( size_t n ) {
+            if( n > owner_.size() ) grow( n );
+            slots.reserve( n );
+        }
+
+        handle create( int type, float start, float end, float duration ) {
+            type = unsigned(type) < TOTAL ? type : int(TYPE::LINEAR);
+            unsigned id = free_head;
+            if( id == NONE ) {
+                id = unsigned( slots.size() );
+                slot s = { 1, 0, 0 };
+                slots.push_back( s );
+            } else {
+                free_head = slots[id].index;
+            }
+            if( first[TOTAL] == owner_.size() ) {
+                grow( owner_.empty() ? 64 : owner_.size() * 2 );
+            }
+            // open a hole at the end of the segment: each later segment hands its
+            // first record over to its end
+            unsigned hole = first[TOTAL]++;
+            for( int j = TOTAL - 1; j > type; --j ) {
+                if( first[j] != hole ) move( first[j], hole );
+                hole = first[j]++;
+            }
+            start_[hole] = start;
+            delta_[hole] = end - start;
+            duration_[hole] = duration;
+            elapsed_[hole] = 0;
+            t_[hole] = duration > 0 ? 0.f : 1.f;
+            value_[hole] = duration > 0 ? start : end;
+            owner_[hole] = id;
+            slots[id].index = hole;
+            slots[id].type = type;
+            return handle( id, slots[id].generation );
+        }
+
+        // false for stale or null handles
+        bool cancel( handle h ) {
+            if( !find( h ) ) return false;
+            slot &s = slots[h.index];
+            // fill the hole from the end of its segment, then each later segment
+            // hands its last record over to the hole before it
+            unsigned hole = s.index, end = first[s.type + 1];
+            if( hole != end - 1 ) move( end - 1, hole );
+            hole = end - 1;
+            for( int j = s.type + 1; j < TOTAL; ++j ) {
+                end = first[j + 1];
+                if( first[j] != end ) move( end - 1, hole );
+                --first[j];
+                hole = end - 1;
+            }
+            --first[TOTAL];
+            s.generation = s.generation + 1 ? s.generation + 1 : 1;
+            s.index = free_head;
+            free_head = h.index;
+            return true;
+        }
+
+        // continues from the current value towards end, over a fresh duration
+        bool retarget( handle h, float end, float duration ) {
+            const slot *s = find( h );
+            if( !s ) return false;
+            unsigned i = s->index;
+            start_[i] = value_[i];
+            delta_[i] = end - value_[i];
+            duration_[i] = duration;
+            elapsed_[i] = 0;
+            t_[i] = duration > 0 ? 0.f : 1.f;
+            value_[i] = duration > 0 ? value_[i] : end;
+            return true;
+        }
+
+        void update( float dt ) {
+            const unsigned n = first[TOTAL];
+            if( !n ) return;
+            float *el = &elapsed_[0], *t = &t_[0], *v = &value_[0];
+            const float *s = &start_[0], *d = &delta_[0], *du = &duration_[0];
+            for( unsigned i = 0; i < n; ++i ) {
+                el[i] += dt;
+                t[i] = el[i] < du[i] ? el[i] / du[i] : 1.f;
+            }
+            for( int type = 0; type < TOTAL; ++type ) {
+                if( first[type] != first[type + 1] ) {
+                    tween::ease( type, t + first[type], v + first[type], first[type + 1] - first[type] );
+                }
+            }
+            for( unsigned i = 0; i < n; ++i ) {
+                v[i] = s[i] + d[i] * v[i];
+            }
+        }
+
+        bool alive( handle h ) const {
+            return find( h ) != 0;
+        }
+        // stale handles read 0
+        float value( handle h ) const {
+            const slot *s = find( h );
+            return s ? value_[s->index] : 0.f;
+        }
+        float progress( handle h ) const {
+            const slot *s = find( h );
+            return s ? t_[s->index] : 0.f;
+        }
+        bool done( handle h ) const {
+            return progress( h ) >= 1.f;
+        }
+        size_t size() const {
+            return first[TOTAL];
+        }
+
+        // dense access, all curves in one array; order changes on create() and cancel()
+        size_t begin( int type ) const { return first[type]; }
+        size_t end( int type ) const { return first[type + 1]; }
+        const float *values() const { return value_.data(); }
+        handle at( size_t i ) const { return handle( owner_[i], slots[ owner_[i] ].generation ); }
+    };
+
+    // scheduler: tweens keyed by absolute begin and end times. waiting ones sit
+    // in a min-heap on their begin time and cost nothing per frame; tick(now)
+    // pops the ones starting, updates the active ones bucketed by curve (one
+    // batch ease() per curve, no clamping of waiting or finished tweens), and
+    // retires the ones that ended. started() and completed() hold the events of
+    // the last tick, in batches. per tick: O(active + starting * log(waiting)).
+    // handles are a slot (low 24 bits), recycled once its tween completes or is
+    // cancelled, and the slot's generation (high 8 bits): stale handles are
+    // rejected until the slot wraps 256 reuses. index( id ) is the slot alone,
+    // for side tables indexed by tween.
+
+    class scheduler {
+    public:
+        struct event {
+            unsigned id;
+            double time;  // scheduled begin or end, not the tick's time
+        };
+
+    private:
+        enum { FREE, WAITING, ACTIVE };
+        struct bucket {
+            std::vector<double> begin, duration, end;
+            std::vector<float> start, delta, t, value;
+            std::vector<unsigned> ids;
+        };
+        enum { SLOT_BITS = 24, SLOT_MASK = (1u << SLOT_BITS) - 1, GENERATION_MASK = 0xFF };
+        struct wait {
+            double begin;
+            unsigned id, serial; /* id: slot */
+            bool operator<( const wait &other ) const { return begin > other.begin; } /* min-heap */
+        };
+        struct slot {
+            int type, state;
+            unsigned index, serial; /* index: in its bucket, while active. serial: stale heap entries and handles */
+            float start, end;
+            double begin, duration;
+        };
+        bucket buckets[TOTAL];
+        std::vector<wait> heap;
+        std::vector<slot> slots;
+        std::vector<unsigned> freed;
+        std::vector<event> starts, completions;
+        size_t waiting, running;
+
+        unsigned handle( unsigned k ) const {
+            return k | (slots[k].serial & GENERATION_MASK) << SLOT_BITS;
+        }
+        // slot of a waiting or active tween, or SLOT_MASK
+        unsigned find( unsigned id ) const {
+            const unsigned k = id & SLOT_MASK;
+            return k < slots.size() && slots[k].state != FREE && handle( k ) == id ? k : unsigned(SLOT_MASK);
+        }
+
+        void release( unsigned k ) {
+            slots[k].state = FREE;
+            ++slots[k].serial;
+            freed.push_back( k );
+        }
+
+        void activate( unsigned k ) {
+            slot &s = slots[k];
+            bucket &b = buckets[s.type];
+            s.state = ACTIVE;
+            s.index = unsigned( b.ids.size() );
+            b.begin.push_back( s.begin );
+            b.duration.push_back( s.duration );
+            b.end.push_back( s.begin + s.duration );
+            b.start.push_back( s.start );
+            b.delta.push_back( s.end - s.start );
+            b.t.push_back( 0 );
+            b.value.push_back( s.start );
+            b.ids.push_back( handle( k ) );
+            --waiting, ++running;
+        }
+
+        // drops stale heap entries: amortized O(1) per cancel, bounds the heap
+        // to twice the waiting tweens however far ahead cancelled ones began
+        void compact() {
+            size_t n = 0;
+            for( size_t i = 0; i < heap.size(); ++i ) {
+                const slot &s = slots[ heap[i].id ];
+                if( s.state == WAITING && s.serial == heap[i].serial ) heap[n++] = heap[i];
+            }
+            heap.resize( n );
+            std::make_heap( heap.begin(), heap.end() );
+        }
+
+        void retire( int type, unsigned index ) {
+            bucket &b = buckets[type];
+            unsigned last = unsigned( b.ids.size() - 1 ), id = b.ids[index];
+            if( index != last ) {
+                b.begin[index] = b.begin[last];
+                b.duration[index] = b.duration[last];
+                b.end[index] = b.end[last];
+                b.start[index] = b.start[last];
+                b.delta[index] = b.delta[last];
+                b.t[index] = b.t[last];
+                b.value[index] = b.value[last];
+                b.ids[index] = b.ids[last];
+                slots[ b.ids[last] & SLOT_MASK ].index = index;
+            }
+            b.begin.pop_back(); b.duration.pop_back(); b.end.pop_back(); b.start.pop_back();
+            b.delta.pop_back(); b.t.pop_back(); b.value.pop_back(); b.ids.pop_back();
+            release( id & SLOT_MASK );
+            --running;
+        }
+
+    public:
+
+        scheduler() : waiting(0), running(0) {}
+
+        // begin is absolute, in the clock tick() is given. ~0u when full (2^24 - 1 tweens)
+        unsigned add( int type, float start, float end, double begin, double duration ) {
+            unsigned id;
+            if( !freed.empty() ) {
+                id = freed.back();
+                freed.pop_back();
+            } else if( slots.size() < SLOT_MASK ) {
+                id = unsigned( slots.size() );
+                slots.push_back( slot() );
+                slots[id].serial = 0;
+            } else {
+                return ~0u;
+            }
+            slot &s = slots[id];
+            s.type = unsigned(type) < TOTAL ? type : int(TYPE::LINEAR);
+            s.state = WAITING;
+            s.start = start, s.end = end;
+            s.begin = begin, s.duration = duration > 0 ? duration : 0;
+            wait w = { begin, id, s.serial };
+            heap.push_back( w );
+            std::push_heap( heap.begin(), heap.end() );
+            ++waiting;
+            return handle( id );
+        }
+
+        // false if id is not waiting nor active, or stale
+        bool cancel( unsigned id ) {
+            const unsigned k = find( id );
+            if( k == SLOT_MASK ) {
+                return false;
+            }
+            if( slots[k].state == ACTIVE ) {
+                retire( slots[k].type, slots[k].index );
+            } else {
+                release( k ); /* its heap entry goes stale */
+                --waiting;
+                if( heap.size() > 2 * waiting + 64 ) {
+                    compact();
+                }
+            }
+            return true;
+        }
+
+        void tick( double now ) {
+            starts.clear();
+            completions.clear();
+            while( !heap.empty() && heap.front().begin <= now ) {
+                wait w = heap.front();
+                std::pop_heap( heap.begin(), heap.end() );
+                heap.pop_back();
+                if( slots[w.id].state == WAITING && slots[w.id].serial == w.serial ) {
+                    activate( w.id );
+                    event e = { handle( w.id ), w.begin };
+                    starts.push_back( e );
+                }
+            }
+            for( int type = 0; type < TOTAL; ++type ) {
+                bucket &b = buckets[type];
+                const size_t n = b.ids.size();
+                if( !n ) continue;
+                float *t = &b.t[0], *v = &b.value[0];
+                const float *s = &b.start[0], *d = &b.delta[0];
+                const double *bg = &b.begin[0], *du = &b.duration[0], *en = &b.end[0];
+                for( size_t i = 0; i < n; ++i ) {
+                    t[i] = now < en[i] ? float( (now - bg[i]) / du[i] ) : 1.f;
+                }
+                tween::ease( type, t, v, n );
+                for( size_t i = 0; i < n; ++i ) {
+                    v[i] = s[i] + d[i] * v[i];
+                }
+                for( size_t i = n; i-- > 0; ) {
+                    if( b.t[i] >= 1.f ) {
+                        event e = { b.ids[i], b.end[i] };
+                        completions.push_back( e );
+                        retire( type, unsigned(i) );
+                    }
+                }
+            }
+        }
+
+        // events of the last tick
+        const std::vector<event> &started() const { return starts; }
+        const std::vector<event> &completed() const { return completions; }
+
+        size_t pending() const { return waiting; }
+        size_t active() const { return running; }
+        bool active( unsigned id ) const { return find( id ) != SLOT_MASK && slots[id & SLOT_MASK].state == ACTIVE; }
+
+        // start value while waiting, last tick's value while active, 0 otherwise
+        float value( unsigned id ) const {
+            const unsigned k = find( id );
+            if( k == SLOT_MASK ) {
+                return 0.f;
+            }
+            const slot &s = slots[k];
+            return s.state == ACTIVE ? buckets[s.type].value[s.index] : s.start;
+        }
+
+        // slot of a handle: dense, below the most tweens alive at once
+        static unsigned index( unsigned id ) { return id & SLOT_MASK; }
+
+        // bulk access to active tweens, per curve bucket; order changes as tweens retire. types out of range: 0, null
+        size_t size( int type ) const { return unsigned(type) < TOTAL ? buckets[type].ids.size() : 0; }
+        const float *values( int type ) const { return unsigned(type) < TOTAL ? buckets[type].value.data() : 0; }
+        const unsigned *ids( int type ) const { return unsigned(type) < TOTAL ? buckets[type].ids.data() : 0; }
+    };
+
+#   if tween$coroutines
+
+    // coroutines, C++20: scripts co_await tweens and delays of a director, which
+    // owns the clock and a scheduler. tick(now) resumes exactly the scripts whose
+    // tween or delay ended, ordered by scheduled end, then by await; nothing is
+    // polled, and awaits allocate nothing (the awaiter lives in the coroutine
+    // frame, the handle in a vector indexed by the scheduler's slots). basic_script is the
+    // coroutine type: lazy, started detached with start() or co_await-ed from
+    // another script to sequence them. frames come from ALLOC, default
+    // constructed (stateless allocators: pools, arenas, frame allocators).
+    // scripts still suspended when their director goes away are not destroyed.
+
+    template<typename ALLOC = std::allocator<unsigned char> >
+    class basic_script {
+    public:
+        struct promise_type {
+            typedef typename std::allocator_traits<ALLOC>::template rebind_alloc<unsigned char> allocator;
+            typedef std::allocator_traits<allocator> traits;
+
+            std::coroutine_handle<> continuation;
+            bool detached = false;
+
+            static void *operator new( size_t n ) {
+                allocator a;
+                return traits::allocate( a, n );
+            }
+            static void operator delete( void *p, size_t n ) {
+                allocator a;
+                traits::deallocate( a, static_cast<unsigned char *>( p ), n );
+            }
+
+            struct final_awaiter {
+                bool await_ready() const noexcept { return false; }
+                std::coroutine_handle<> await_suspend( std::coroutine_handle<promise_type> h ) noexcept {
+                    std::coroutine_handle<> next = h.promise().continuation;
+                    if( h.promise().detached ) {
+                        h.destroy();
+                    }
+                    return next ? next : std::noop_coroutine();
+                }
+                void await_resume() const noexcept {}
+            };
+
+            basic_script get_return_object() { return basic_script( std::coroutine_handle<promise_type>::from_promise( *this ) ); }
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            final_awaiter final_suspend() const noexcept { return {}; }
+            void return_void() const {}
+            void unhandled_exception() const { std::terminate(); }
+        };
+
+    private:
+        std::coroutine_handle<promise_type> h;
+        explicit basic_script( std::coroutine_handle<promise_type> h ) : h( h ) {}
+
+    public:
+        basic_script( basic_script &&other ) noexcept : h( other.h ) { other.h = nullptr; }
+        basic_script &operator=( basic_script && ) = delete;
+        ~basic_script() { if( h ) h.destroy(); }
+
+        bool done() const { return !h || h.done(); }
+
+        // runs until its first await; the frame frees itself on return
+        void start() && {
+            std::coroutine_handle<promise_type> c = h;
+            h = nullptr;
+            c.promise().detached = true;
+            c.resume();
+        }
+
+        // co_await script: runs it, resumes the caller when it returns
+        bool await_ready() const noexcept { return done(); }
+        std::coroutine_handle<> await_suspend( std::coroutine_handle<> caller ) noexcept {
+            h.promise().continuation = caller;
+            return h;
+        }
+        void await_resume() const noexcept {}
+    };
+    typedef basic_script<> script;
+
+    class director {
+        scheduler timeline_;
+        double now_;
+        struct wakeup {
+            double time;
+            unsigned long long order;
+            std::coroutine_handle<> h;
+            bool operator<( const wakeup &other ) const { return time < other.time || (time == other.time && order < other.order); }
+        };
+        std::vector<std::coroutine_handle<> > waiters;
+        std::vector<wakeup> ready;
+        std::vector<float *> targets;
+        std::vector<float> ends;
+        std::vector<unsigned long long> orders;
+        unsigned long long awaits = 0;
+
+    public:
+
+        struct awaiter {
+            director &owner;
+            int type;
+            float start, end;
+            double delay, duration;
+            float *target;
+
+            bool await_ready() const noexcept { return false; }
+            // a full scheduler does not suspend: the script goes on at once
+            bool await_suspend( std::coroutine_handle<> h ) {
+                director &d = owner;
+                unsigned id = d.timeline_.add( type, start, end, d.now_ + delay, duration );
+                if( id == ~0u ) {
+                    return false;
+                }
+                const unsigned k = scheduler::index( id );
+                if( k >= d.waiters.size() ) {
+                    d.waiters.resize( k + 1 ), d.targets.resize( k + 1 ), d.ends.resize( k + 1 ), d.orders.resize( k + 1 );
+                }
+                d.waiters[k] = h, d.targets[k] = target, d.ends[k] = end, d.orders[k] = d.awaits++;
+                return true;
+            }
+            float await_resume() const noexcept { return end; }
+        };
+
+        explicit director( double now = 0 ) : now_( now ) {}
+
+        // co_await play(...): tweens from now, *target (optional) follows it every
+        // tick and ends at end; the script resumes on the tick it completes
+        awaiter play( int type, float start, float end, double duration, float *target = 0 ) {
+            return awaiter { *this, type, start, end, 0, duration, target };
+        }
+        // co_await delay( seconds ): resumes on the first tick at or past now + seconds
+        awaiter delay( double seconds ) {
+            return awaiter { *this, TYPE::LINEAR, 0, 0, seconds, 0, 0 };
+        }
+
+        void tick( double now ) {
+            now_ = now;
+            timeline_.tick( now );
+            for( int type = 0; type < TOTAL; ++type ) {
+                const unsigned *ids = timeline_.ids( type );
+                const float *values = timeline_.values( type );
+                for( size_t i = 0, n = timeline_.size( type ); i < n; ++i ) {
+                    if( float *t = targets[ scheduler::index( ids[i] ) ] ) *t = values[i];
+                }
+            }
+            ready.clear();
+            for( const scheduler::event &e : timeline_.completed() ) {
+                const unsigned k = scheduler::index( e.id );
+                if( float *t = targets[k] ) *t = ends[k];
+                if( waiters[k] ) {
+                    wakeup w = { e.time, orders[k], waiters[k] };
+                    ready.push_back( w );
+                }
+                waiters[k] = nullptr, targets[k] = 0;
+            }
+            // completion order: scheduled end, then await order on ties
+            std::sort( ready.begin(), ready.end() );
+            for( size_t i = 0; i < ready.size(); ++i ) {
+                ready[i].h.resume();
+            }
+        }
+
+        double now() const { return now_; }
+        const scheduler &timeline() const { return timeline_; }
+    };
+
+#   endif
+
+    // parallel: persistent thread pool for very large batches. input is cut into
+    // cache-sized chunks aligned to 64-byte lines of the output (no false sharing);
+    // each worker owns a range of chunks, pops from its front and steals half of a
+    // victim's back when idle. mixed-type inputs are bucketed by curve per chunk.
+    // the calling thread works too, so parallel(1) runs inline.
+
+    class parallel {
+        struct range {
+            std::atomic<unsigned long long> lohi; // lo in low 32 bits, hi in high 32 bits
+            char pad[64 - sizeof(std::atomic<unsigned long long>)];
+            range() : lohi(0) {}
+        };
+        struct scratch {
+            std::vector<unsigned> index;
+            std::vector<float> t, out;
+        };
+
+        const int *types;
+        int type;
+        const float *in;
+        float *out;
+        size_t n, head, chunk;
+        unsigned chunks;
+
+        std::vector<range> ranges;
+        std::vector<scratch> scratches;
+        std::vector<std::thread> workers;
+        std::atomic<unsigned> pending, active;
+        std::mutex mutex;
+        std::condition_variable wake;
+        unsigned generation;
+        bool quit;
+
+        static unsigned long long pack( unsigned lo, unsigned hi ) { return (unsigned long long)(hi) << 32 | lo; }
+
+        bool pop( unsigned self, unsigned &k ) {
+            unsigned long long r = ranges[self].lohi.load( std::memory_order_acquire );
+            for( ;; ) {
+                unsigned lo = unsigned(r), hi = unsigned(r >> 32);
+                if( lo >= hi ) return false;
+                if( ranges[self].lohi.compare_exchange_weak( r, pack( lo + 1, hi ), std::memory_order_acq_rel ) ) {
+                    return k = lo, true;
+                }
+            }
+        }
+        bool steal( unsigned self ) {
+            const unsigned W = unsigned( ranges.size() );
+            for( unsigned i = 1; i < W; ++i ) {
+                range &victim = ranges[ (self + i) % W ];
+                unsigned long long r = victim.lohi.load( std::memory_order_acquire );
+                for( ;; ) {
+                    unsigned lo = unsigned(r), hi = unsigned(r >> 32);
+                    if( lo >= hi ) break;
+                    unsigned mid = hi - (hi - lo + 1) / 2;
+                    if( victim.lohi.compare_exchange_weak( r, pack( lo, mid ), std::memory_order_acq_rel ) ) {
+                        ranges[self].lohi.store( pack( mid, hi ), std::memory_order_release );
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        void process( unsigned k, scratch &s ) {
+            size_t b = k ? head + (k - 1) * chunk : 0, e = head + k * chunk;
+            e = e < n ? e : n;
+            const size_t len = e - b;
+            if( !types ) {
+                return tween::ease( type, in + b, out + b, len );
+            }
+            // counting sort by curve, batch each bucket, scatter back. runtime
+            // curves share the last bucket and are evaluated one by one, in place
+            size_t offset[TOTAL + 2] = {0};
+            for( size_t i = b; i < e; ++i ) {
+                ++offset[ (unsigned(types[i]) < TOTAL ? types[i] : int(TOTAL)) + 1 ];
+            }
+            for( int j = 0; j <= TOTAL; ++j ) {
+                if( j < TOTAL && offset[j + 1] == len ) return tween::ease( j, in + b, out + b, len );
+                offset[j + 1] += offset[j];
+            }
+            size_t fill[TOTAL];
+            for( int j = 0; j < TOTAL; ++j ) fill[j] = offset[j];
+            for( size_t i = b; i < e; ++i ) {
+                if( unsigned(types[i]) >= TOTAL ) {
+                    out[i] = tween::ease<float>( types[i], in[i] );
+                    continue;
+                }
+                size_t at = fill[ types[i] ]++;
+                s.index[at] = unsigned(i);
+                s.t[at] = in[i];
+            }
+            for( int j = 0; j < TOTAL; ++j ) {
+                if( offset[j + 1] > offset[j] ) {
+                    tween::ease( j, &s.t[ offset[j] ], &s.out[ offset[j] ], offset[j + 1] - offset[j] );
+                }
+            }
+            for( size_t i = 0; i < offset[TOTAL]; ++i ) {
+                out[ s.index[i] ] = s.out[i];
+            }
+        }
+
+        void work( unsigned self ) {
+            unsigned k;
+            do {
+                while( pop( self, k ) ) {
+                    process( k, scratches[self] );
+                    pending.fetch_sub( 1, std::memory_order_acq_rel );
+                }
+            } while( steal( self ) );
+        }
+
+        void loop( unsigned self ) {
+            unsigned seen = 0;
+            for( ;; ) {
+                {
+                    std::unique_lock<std::mutex> lock( mutex );
+                    while( !quit && generation == seen ) wake.wait( lock );
+                    if( quit ) return;
+                    seen = generation;
+                }
+                work( self );
+                active.fetch_sub( 1, std::memory_order_acq_rel );
+            }
+        }
+
+        void run() {
+            const size_t first = size_t((64 - (reinterpret_cast<size_t>(out) & 63)) & 63) / sizeof(float);
+            head = first && first < n ? first : (chunk < n ? chunk : n);
+            chunks = n > head ? unsigned( 1 + (n - head + chunk - 1) / chunk ) : 1;
+            const unsigned W = unsigned( ranges.size() );
+            if( W == 1 || chunks == 1 ) {
+                for( unsigned k = 0; k < chunks; ++k ) process( k, scratches[0] );
+                return;
+            }
+            for( unsigned w = 0; w < W; ++w ) {
+                ranges[w].lohi.store( pack( unsigned( (unsigned long long)chunks * w / W ), unsigned( (unsigned long long)chunks * (w + 1) / W ) ), std::memory_order_relaxed );
+            }
+            pending.store( chunks, std::memory_order_relaxed );
+            active.store( W - 1, std::memory_order_relaxed );
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                ++generation;
+            }
+            wake.notify_all();
+            work( 0 );
+            while( pending.load( std::memory_order_acquire ) || active.load( std::memory_order_acquire ) ) {
+                std::this_thread::yield();
+            }
+        }
+
+        parallel( const parallel & );
+        parallel &operator=( const parallel & );
+
+    public:
+
+        explicit parallel( unsigned threads = std::thread::hardware_concurrency(), size_t chunk_size = 4096 ) :
+            types(0), type(0), in(0), out(0), n(0), head(0), chunk((chunk_size + 15) / 16 * 16), chunks(0),
+            ranges(threads ? threads : 1), scratches(threads ? threads : 1), pending(0), active(0), generation(0), quit(false) {
+            chunk = chunk ? chunk : 16;
+            for( size_t w = 0; w < scratches.size(); ++w ) {
+                scratches[w].index.resize( chunk );
+                scratches[w].t.resize( chunk );
+                scratches[w].out.resize( chunk );
+            }
+            for( unsigned w = 1; w < ranges.size(); ++w ) {
+                workers.push_back( std::thread( &parallel::loop, this, w ) );
+            }
+        }
+        ~parallel() {
+            {
+                std::lock_guard<std::mutex> lock( mutex );
+                quit = true;
+            }
+            wake.notify_all();
+            for( size_t w = 0; w < workers.size(); ++w ) workers[w].join();
+        }
+
+        unsigned threads() const { return unsigned( ranges.size() ); }
+        size_t chunk_size() const { return chunk; }
+
+        // one curve for all samples
+        void ease( int type_, const float *dt01, float *out_, size_t n_ ) {
+            types = 0, type = type_, in = dt01, out = out_, n = n_;
+            if( n ) run();
+        }
+        // per-sample curves
+        void ease( const int *type_, const float *dt01, float *out_, size_t n_ ) {
+            types = type_, type = 0, in = dt01, out = out_, n = n_;
+            if( n ) run();
+        }
+    };
+
+    // track: keyframes (time, value, curve). each key's curve eases the segment
+    // that starts at it. sampling keeps a cursor on the last segment hit, so
+    // playing forward is amortized O(1); seeks fall back to a binary search.
+
+    class track {
+        std::vector<float> times, values;
+        std::vector<int> types;
+        size_t cursor;
+
+    public:
+
+        track() : cursor(0) {}
+
+        void add( float time, float value, int type = TYPE::LINEAR ) {
+            size_t at = size_t( std::upper_bound( times.begin(), times.end(), time ) - times.begin() );
+            times.insert( times.begin() + at, time );
+            values.insert( values.begin() + at, value );
+            types.insert( types.begin() + at, type );
+            cursor = 0;
+        }
+        void clear() {
+            times.clear(), values.clear(), types.clear(), cursor = 0;
+        }
+        size_t size() const {
+            return times.size();
+        }
+        float duration() const {
+            return times.empty() ? 0 : times.back() - times.front();
+        }
+
+        // locates the segment for time; returns false when clamped to either end
+        bool seek( float time, size_t &segment ) {
+            const size_t n = times.size();
+            if( n < 2 || time <= times[0] ) return segment = 0, false;
+            if( time >= times[n-1] ) return segment = n - 1, false;
+            size_t c = cursor;
+            if( !(times[c] <= time && time < times[c+1]) ) {
+                if( c + 2 < n && times[c+1] <= time && time < times[c+2] ) {
+                    ++c;
+                } else {
+                    c = size_t( std::upper_bound( times.begin(), times.end(), time ) - times.begin() ) - 1;
+                }
+                cursor = c;
+            }
+            return segment = c, true;
+        }
+
+        float sample( float time ) {
+            size_t s;
+            if( !seek( time, s ) ) return values.empty() ? 0 : values[s];
+            float t = (time - times[s]) / (times[s+1] - times[s]);
+            return values[s] + (values[s+1] - values[s]) * float( tween::ease( types[s], t ) );
+        }
+
+        // samples many tracks at one time; segments are bucketed by curve so each
+        // curve runs a single batch ease(). keep a scratch around to skip allocations.
+        struct scratch {
+            std::vector<size_t> segment;
+            std::vector<unsigned> order;
+            std::vector<float> t, eased;
+        };
+        static void sample( track *tracks, size_t count, float time, float *out ) {
+            scratch s;
+            sample( tracks, count, time, out, s );
+        }
+        static void sample( track *tracks, size_t count, float time, float *out, scratch &scratch ) {
+            size_t offset[TOTAL + 1] = {0}, fill[TOTAL];
+            std::vector<size_t> &segment = scratch.segment;
+            std::vector<unsigned> &order = scratch.order;
+            std::vector<float> &t = scratch.t, &eased = scratch.eased;
+            segment.resize( count ), order.resize( count ), t.resize( count ), eased.resize( count );
+            for( size_t i = 0; i < count; ++i ) {
+                track &k = tracks[i];
+                if( k.seek( time, segment[i] ) ) {
+                    int type = k.types[ segment[i] ];
+                    if( unsigned(type) < TOTAL ) ++offset[ type + 1 ];
+                } else {
+                    out[i] = k.values.empty() ? 0 : k.values[ segment[i] ];
+                    segment[i] = ~size_t(0);
+                }
+            }
+            for( int j = 0; j < TOTAL; ++j ) {
+                offset[j + 1] += offset[j];
+                fill[j] = offset[j];
+            }
+            for( size_t i = 0; i < count; ++i ) {
+                if( segment[i] == ~size_t(0) ) continue;
+                const track &k = tracks[i];
+                const size_t s = segment[i];
+                int type = k.types[s];
+                float u = (time - k.times[s]) / (k.times[s+1] - k.times[s]);
+                if( unsigned(type) >= TOTAL ) {
+                    // runtime curves: one by one, like sample( time )
+                    out[i] = k.values[s] + (k.values[s+1] - k.values[s]) * float( tween::ease( type, u ) );
+                    continue;
+                }
+                size_t at = fill[ type ]++;
+                order[at] = unsigned(i);
+                t[at] = u;
+            }
+            for( int j = 0; j < TOTAL; ++j ) {
+                if( offset[j + 1] > offset[j] ) {
+                    tween::ease( j, &t[ offset[j] ], &eased[ offset[j] ], offset[j + 1] - offset[j] );
+                }
+            }
+            for( size_t at = 0; at < offset[TOTAL]; ++at ) {
+                const track &k = tracks[ order[at] ];
+                const size_t s = segment[ order[at] ];
+                out[ order[at] ] = k.values[s] + (k.values[s+1] - k.values[s]) * eased[at];
+            }
+        }
+    };
+
+    // multi-channel interpolation: the curve is evaluated once per sample, then
+    // all N channels (vec2/3/4, rgba...) are blended together; sse2 handles 4 at
+    // a time. quaternions are (x,y,z,w) and blend along the shortest arc.
+
+    namespace detail {
+        static inline void blend( const float *a, const float *b, float e, float *out, unsigned n ) {
+            unsigned i = 0;
+#           if tween$sse2
+            for( __m128 E = _mm_set1_ps( e ); i + 4 <= n; i += 4 ) {
+                __m128 A = _mm_loadu_ps( a + i );
+                _mm_storeu_ps( out + i, _mm_add_ps( A, _mm_mul_ps( _mm_sub_ps( _mm_loadu_ps( b + i ), A ), E ) ) );
+            }
+#           endif
+            for( ; i < n; ++i ) {
+                out[i] = a[i] + (b[i] - a[i]) * e;
+            }
+        }
+        static inline void normalize4( float *q ) {
+            float len = std::sqrt( q[0]*q[0] + q[1]*q[1] + q[2]*q[2] + q[3]*q[3] );
+            float inv = len > 0 ? 1 / len : 0;
+            q[0] *= inv, q[1] *= inv, q[2] *= inv, q[3] *= inv;
+        }
+        static inline void slerp( const float *a, const float *b, float e, float *out ) {
+            float d = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3], s = d < 0 ? -1.f : 1.f;
+            d *= s;
+            if( d > 0.9995f ) {
+                // nearly parallel: nlerp is accurate and avoids dividing by sin(~0)
+                for( int i = 0; i < 4; ++i ) out[i] = a[i] + (s * b[i] - a[i]) * e;
+                return normalize4( out );
+            }
+            float theta = std::acos( d ), inv = 1 / std::sin( theta );
+            float wa = std::sin( (1 - e) * theta ) * inv, wb = s * std::sin( e * theta ) * inv;
+            for( int i = 0; i < 4; ++i ) out[i] = wa * a[i] + wb * b[i];
+        }
+        // eases count samples in small stack chunks, then calls fn( index, eased )
+        template<typename FN>
+        static inline void chunked( int type, const float *t, size_t count, FN fn ) {
+            float eased[256];
+            for( size_t base = 0; base < count; base += 256 ) {
+                size_t len = count - base < 256 ? count - base : 256;
+                tween::ease( type, t + base, eased, len );
+                for( size_t i = 0; i < len; ++i ) fn( base + i, eased[i] );
+            }
+        }
+    }
+
+    template<unsigned N>
+    static inline void lerp( int type, double dt01, const float *a, const float *b, float *out ) {
+        detail::blend( a, b, float( ease( type, dt01 ) ), out, N );
+    }
+    template<unsigned N>
+    static inline void lerp( int type, const float *dt01, const float *a, const float *b, float *out, size_t count ) {
+        detail::chunked( type, dt01, count, [&]( size_t i, float e ) { detail::blend( a + i * N, b + i * N, e, out + i * N, N ); } );
+    }
+
+    static inline void nlerp( int type, double dt01, const float *a, const float *b, float *out ) {
+        float e = float( ease( type, dt01 ) ), s = a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3] < 0 ? -1.f : 1.f;
+        for( int i = 0; i < 4; ++i ) out[i] = a[i] + (s * b[i] - a[i]) * e;
+        detail::normalize4( out );
+    }
+    static inline void nlerp( int type, const float *dt01, const float *a, const float *b, float *out, size_t count ) {
+        detail::chunked( type, dt01, count, [&]( size_t i, float e ) {
+            const float *qa = a + i * 4, *qb = b + i * 4;
+            float s = qa[0]*qb[0] + qa[1]*qb[1] + qa[2]*qb[2] + qa[3]*qb[3] < 0 ? -1.f : 1.f;
+            for( int c = 0; c < 4; ++c ) out[i * 4 + c] = qa[c] + (s * qb[c] - qa[c]) * e;
+            detail::normalize4( out + i * 4 );
+        } );
+    }
+
+    static inline void slerp( int type, double dt01, const float *a, const float *b, float *out ) {
+        detail::slerp( a, b, float( ease( type, dt01 ) ), out );
+    }
+    static inline void slerp( int type, const float *dt01, const float *a, const float *b, float *out, size_t count ) {
+        detail::chunked( type, dt01, count, [&]( size_t i, float e ) { detail::slerp( a + i * 4, b + i * 4, e, out + i * 4 ); } );
+    }
+
+    // fixed point: t is Q16 (0..65535 ~ [0,1)), result is Q15 saturated to
+    // [-32768,32767] (overshooting curves clip at ~1). backed by per-curve Q14
+    // tables of 1024 segments (room for overshoot), built lazily and linearly interpolated; integer
+    // only once the table is built. ease_q15_error() measures the max abs error
+    // in Q15 LSBs over all inputs: 1-2 LSBs for smooth curves (up to 4 on ELASTIC*), ~32 for EXPO* (the
+    // jump at 0), ~65 for BOUNCE* (kinks inside segments), ~360 for CIRC* (the
+    // infinite slopes at the borders). runtime curves are evaluated exactly.
+
+    namespace detail {
+        enum { Q15_BITS = 10, Q15_SEGMENTS = 1 << Q15_BITS, Q15_FRAC = 16 - Q15_BITS };
+
+        static inline const short *q15_row( int type ) {
+            enum { EMPTY, BUILDING, READY };
+            static short lut[TOTAL][Q15_SEGMENTS + 2]; /* +1 end point, +1 pad for 32-bit pair loads */
+            static std::atomic<int> state[TOTAL];
+            type = unsigned(type) < TOTAL ? type : int(TYPE::LINEAR);
+            if( state[type].load( std::memory_order_acquire ) != READY ) {
+                int expected = EMPTY;
+                if( state[type].compare_exchange_strong( expected, BUILDING, std::memory_order_acq_rel ) ) {
+                    tween$stats_build( type );
+                    for( int i = 0; i <= Q15_SEGMENTS; ++i ) {
+                        double v = std::floor( tween::ease( type, double(i) / double(Q15_SEGMENTS) ) * 16384 + 0.5 );
+                        lut[type][i] = short( v < -32768 ? -32768 : v > 32767 ? 32767 : v );
+                    }
+                    lut[type][Q15_SEGMENTS + 1] = lut[type][Q15_SEGMENTS];
+                    state[type].store( READY, std::memory_order_release );
+                } else {
+                    while( state[type].load( std::memory_order_acquire ) != READY ) std::this_thread::yield();
+                }
+            }
+            return lut[type];
+        }
+        static inline short q15( const short *row, unsigned t ) {
+            int i = int(t >> Q15_FRAC), f = int(t & ((1 << Q15_FRAC) - 1));
+            int v = (row[i] * (1 << (Q15_FRAC + 1)) + (row[i+1] - row[i]) * f * 2 + (1 << (Q15_FRAC - 1))) >> Q15_FRAC; /* Q14 -> Q15; no left shifts of negatives */
+            return short( v < -32768 ? -32768 : v > 32767 ? 32767 : v );
+        }
+        // runtime curves have no table: rounded from the exact curve
+        static inline short q15_custom( int type, unsigned t ) {
+            double v = std::floor( tween::ease( type, t / 65536.0 ) * 32768 + 0.5 );
+            return short( v < -32768 ? -32768 : v > 32767 ? 32767 : v );
+        }
+    }
+
+    static inline
+    short ease_q15( int type, unsigned short dt ) {
+        if( unsigned(type) >= TOTAL && detail::find_curve( type ) ) {
+            return detail::q15_custom( type, dt );
+        }
+        return detail::q15( detail::q15_row( type ), dt );
+    }
+
+    static inline
+    void ease_q15( int type, const unsigned short *dt, short *out, size_t n ) {
+        if( unsigned(type) >= TOTAL && detail::find_curve( type ) ) {
+            for( size_t i = 0; i < n; ++i ) out[i] = detail::q15_custom( type, dt[i] );
+            return;
+        }
+        const short *row = detail::q15_row( type );
+        size_t i = 0;
+#       if tween$avx2
+        // 16 lanes per step: each 32-bit gather fetches the (row[i], row[i+1]) pair
+        const int *base = reinterpret_cast<const int *>( row );
+        const __m256i fmask = _mm256_set1_epi32( (1 << detail::Q15_FRAC) - 1 ), round = _mm256_set1_epi32( 1 << (detail::Q15_FRAC - 1) );
+        for( ; i + 16 <= n; i += 16 ) {
+            __m256i half[2];
+            for( int h = 0; h < 2; ++h ) {
+                __m256i t = _mm256_cvtepu16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i *>( dt + i + h * 8 ) ) );
+                __m256i pair = _mm256_i32gather_epi32( base, _mm256_srli_epi32( t, detail::Q15_FRAC ), 2 );
+                __m256i a = _mm256_srai_epi32( _mm256_slli_epi32( pair, 16 ), 16 ), b = _mm256_srai_epi32( pair, 16 );
+                __m256i d = _mm256_slli_epi32( _mm256_mullo_epi32( _mm256_sub_epi32( b, a ), _mm256_and_si256( t, fmask ) ), 1 );
+                __m256i v = _mm256_add_epi32( _mm256_add_epi32( _mm256_slli_epi32( a, detail::Q15_FRAC + 1 ), d ), round );
+                half[h] = _mm256_srai_epi32( v, detail::Q15_FRAC ); /* Q14 -> Q15 */
+            }
+            __m256i packed = _mm256_permute4x64_epi64( _mm256_packs_epi32( half[0], half[1] ), 0xD8 ); /* saturates */
+            _mm256_storeu_si256( reinterpret_cast<__m256i *>( out + i ), packed );
+        }
+#       endif
+        for( ; i < n; ++i ) {
+            out[i] = detail::q15( row, dt[i] );
+        }
+    }
+
+    static inline
+    double ease_q15_error( int type ) {
+        double worst = 0;
+        for( unsigned t = 0; t < 65536; ++t ) {
+            double ref = tween::ease( type, t / 65536.0 ) * 32768;
+            ref = ref < -32768 ? -32768 : ref > 32767 ? 32767 : ref;
+            double e = std::abs( ease_q15( type, (unsigned short)t ) - ref );
+            worst = e > worst ? e : worst;
+        }
+        return worst;
+    }
+
+    // curve banks: tables built once by bank_builder, saved to a versioned
+    // binary file and mapped read-only by every process that opens it, so the
+    // pages are shared and a warm start evaluates nothing. install() points the
+    // memoized ease() of the bank's builtin curves at the mapping, and registers
+    // its custom curves as runtime curves backed by their rows (memoized: same
+    // lookup, exact: linear interpolation). an installed mapping stays for the
+    // process. posix maps the file; elsewhere it is read into memory.
+    //
+    // layout, host byte order (recorded in the header; foreign files are rejected):
+    //   header   "TWEENBNK", version, byte order mark, entry count, entry size, file size
+    //   entries  name[48], type (-1: custom), slots, element, max abs error, row offset
+    //   rows     64-byte aligned, slots elements each
+    // max abs error is the one of the memoized lookup against the curve.
+
+    namespace detail {
+        struct bank_header {
+            char magic[8];
+            std::uint32_t version, order, count, entry_size;
+            std::uint64_t bytes;
+        };
+        struct bank_entry {
+            char name[48];
+            std::int32_t type;
+            std::uint32_t slots, element, reserved;
+            double max_error;
+            std::uint64_t offset;
+        };
+        enum { BANK_VERSION = 1, BANK_ORDER = 0x01020304, BANK_ALIGN = 64 };
+
+        static inline size_t bank_element_size( int element ) {
+            return element == BANK_DOUBLE ? sizeof(double) : element == BANK_HALF ? sizeof(half) : sizeof(float);
+        }
+
+        // read-only view of a whole file
+        struct mapping {
+            const unsigned char *data;
+            size_t size;
+            std::vector<unsigned char> copy;
+
+            explicit mapping( const char *path ) : data( 0 ), size( 0 ) {
+#               if tween$mmap
+                int fd = ::open( path, O_RDONLY );
+                struct stat st;
+                if( fd >= 0 && ::fstat( fd, &st ) == 0 && st.st_size > 0 ) {
+                    void *p = ::mmap( 0, size_t( st.st_size ), PROT_READ, MAP_SHARED, fd, 0 );
+                    if( p != MAP_FAILED ) {
+                        data = static_cast<const unsigned char *>( p ), size = size_t( st.st_size );
+                    }
+                }
+                if( fd >= 0 ) ::close( fd );
+#               else
+                if( FILE *fp = std::fopen( path, "rb" ) ) {
+                    char buf[4096];
+                    for( size_t n; (n = std::fread( buf, 1, sizeof(buf), fp )) > 0; ) copy.insert( copy.end(), buf, buf + n );
+                    std::fclose( fp );
+                    data = copy.empty() ? 0 : &copy[0], size = copy.size();
+                }
+#               endif
+            }
+            ~mapping() {
+#               if tween$mmap
+                if( data ) ::munmap( const_cast<unsigned char *>( data ), size );
+#               endif
+            }
+            mapping( const mapping & ) = delete;
+            mapping &operator=( const mapping & ) = delete;
+        };
+    }
+
+    class bank_builder {
+        struct curve {
+            std::string name;
+            int type;
+            std::function<double( double )> fn;
+        };
+        std::vector<curve> curves;
+        unsigned slots_;
+        int element_;
+
+    public:
+
+        explicit bank_builder( unsigned slots = 256, int element = BANK_FLOAT )
+        : slots_( slots < 2 ? 2 : slots ), element_( element == BANK_DOUBLE || element == BANK_HALF ? element : int(BANK_FLOAT) )
+        {}
+
+        // builtin TYPEs keep their id; runtime curves are stored by name, as custom ones
+        bank_builder &add( int type ) {
+            if( unsigned(type) < TOTAL || detail::find_curve( type ) ) {
+                curves.push_back( curve { nameof( type ), unsigned(type) < TOTAL ? type : -1, [type]( double t ) { return ease( type, t ); } } );
+            }
+            return *this;
+        }
+        bank_builder &add( const char *name, const std::function<double( double )> &fn ) {
+            curves.push_back( curve { name ? name : "CUSTOM", -1, fn } );
+            return *this;
+        }
+
+        // the file image
+        std::string data() const {
+            const size_t row = slots_ * detail::bank_element_size( element_ );
+            auto align = []( size_t n ) { return (n + detail::BANK_ALIGN - 1) / detail::BANK_ALIGN * detail::BANK_ALIGN; };
+            std::vector<detail::bank_entry> entries( curves.size() );
+            size_t offset = align( sizeof(detail::bank_header) + entries.size() * sizeof(detail::bank_entry) );
+            for( size_t i = 0; i < entries.size(); ++i ) {
+                std::strncpy( entries[i].name, curves[i].name.c_str(), sizeof(entries[i].name) - 1 );
+                entries[i].type = curves[i].type;
+                entries[i].slots = slots_;
+                entries[i].element = unsigned( element_ );
+                entries[i].offset = offset;
+                offset = align( offset + row );
+            }
+            std::string out( offset, '\0' );
+            for( size_t i = 0; i < entries.size(); ++i ) {
+                char *p = &out[ size_t( entries[i].offset ) ];
+                for( unsigned j = 0; j < slots_; ++j ) {
+                    double v = curves[i].fn( double(j) / (slots_ - 1) );
+                    float f = float( v );
+                    half h( v );
+                    std::memcpy( p + j * detail::bank_element_size( element_ ), element_ == BANK_DOUBLE ? (const void *)&v : element_ == BANK_HALF ? (const void *)&h : (const void *)&f, detail::bank_element_size( element_ ) );
+                }
+                detail::bank_row r = { p, slots_, element_ };
+                const unsigned samples = (slots_ - 1) * 16;
+                for( unsigned j = 0; j <= samples; ++j ) {
+                    double t = double(j) / samples, e = std::abs( r.nearest( t ) - curves[i].fn( t ) );
+                    entries[i].max_error = e > entries[i].max_error ? e : entries[i].max_error;
+                }
+                // lookups truncate: slot j also answers up to the next slot, which
+                // the samples only reach from the right
+                for( unsigned j = 0; j + 1 < slots_; ++j ) {
+                    double e = std::abs( r.at( j ) - curves[i].fn( double(j + 1) / (slots_ - 1) ) );
+                    entries[i].max_error = e > entries[i].max_error ? e : entries[i].max_error;
+                }
+            }
+            detail::bank_header h = { { 'T', 'W', 'E', 'E', 'N', 'B', 'N', 'K' }, detail::BANK_VERSION, detail::BANK_ORDER,
+                std::uint32_t( entries.size() ), std::uint32_t( sizeof(detail::bank_entry) ), std::uint64_t( offset ) };
+            std::memcpy( &out[0], &h, sizeof(h) );
+            if( !entries.empty() ) {
+                std::memcpy( &out[ sizeof(h) ], &entries[0], entries.size() * sizeof(detail::bank_entry) );
+            }
+            return out;
+        }
+
+        bool save( const char *path ) const {
+            std::string image = data();
+            FILE *fp = std::fopen( path, "wb" );
+            if( !fp ) {
+                return false;
+            }
+            bool ok = std::fwrite( image.data(), 1, image.size(), fp ) == image.size();
+            return std::fclose( fp ) == 0 && ok;
+        }
+    };
+
+    class bank {
+        std::shared_ptr<detail::mapping> map;
+        const detail::bank_entry *entries;
+        size_t count;
+        std::vector<int> ids;
+
+        detail::bank_row row( size_t i ) const {
+            detail::bank_row r = { map->data + entries[i].offset, entries[i].slots, int( entries[i].element ) };
+            return r;
+        }
+        static bool same( const detail::bank_row *a, const detail::bank_row &b ) {
+            return a && a->slots == b.slots && a->element == b.element
+                && (a->data == b.data || !std::memcmp( a->data, b.data, b.slots * detail::bank_element_size( b.element ) ));
+        }
+
+    public:
+
+        bank() : entries( 0 ), count( 0 ) {}
+        explicit bank( const char *path ) : bank() {
+            open( path );
+        }
+
+        // maps and validates the file; false leaves the bank empty
+        bool open( const char *path ) {
+            *this = bank();
+            std::shared_ptr<detail::mapping> m = std::make_shared<detail::mapping>( path );
+            detail::bank_header h;
+            if( m->size < sizeof(h) ) {
+                return false;
+            }
+            std::memcpy( &h, m->data, sizeof(h) );
+            if( std::memcmp( h.magic, "TWEENBNK", 8 ) || h.version != detail::BANK_VERSION || h.order != detail::BANK_ORDER
+                || h.entry_size != sizeof(detail::bank_entry) || h.bytes > m->size
+                || h.count > (m->size - sizeof(h)) / sizeof(detail::bank_entry) ) {
+                return false;
+            }
+            const detail::bank_entry *e = reinterpret_cast<const detail::bank_entry *>( m->data + sizeof(h) );
+            for( size_t i = 0; i < h.count; ++i ) {
+                if( e[i].slots < 2 || e[i].element > BANK_HALF || e[i].offset % detail::BANK_ALIGN
+                    || e[i].offset > h.bytes || (h.bytes - e[i].offset) / detail::bank_element_size( int( e[i].element ) ) < e[i].slots
+                    || std::memchr( e[i].name, 0, sizeof(e[i].name) ) == 0 || e[i].type >= int(TOTAL) || e[i].type < -1 ) {
+                    return false;
+                }
+            }
+            map = m, entries = e, count = h.count;
+            ids.assign( count, -1 );
+            return true;
+        }
+
+        bool ok() const { return map != nullptr; }
+        size_t size() const { return count; }
+
+        const char *name( size_t i ) const { return entries[i].name; }
+        int type( size_t i ) const { return entries[i].type; }  // -1: custom
+        unsigned slots( size_t i ) const { return entries[i].slots; }
+        int element( size_t i ) const { return int( entries[i].element ); }
+        double max_error( size_t i ) const { return entries[i].max_error; }
+        int id( size_t i ) const { return ids[i]; }  // after install(): the TYPE, or the runtime id of a custom curve
+
+        int find( const char *name ) const {
+            for( size_t i = 0; i < count; ++i ) {
+                if( !std::strcmp( entries[i].name, name ) ) return int(i);
+            }
+            return -1;
+        }
+
+        // memoized lookup of curve i, straight from the mapping
+        double operator()( size_t i, double dt01 ) const {
+            return row( i ).nearest( dt01 < 0 ? 0 : dt01 > 1 ? 1 : dt01 );
+        }
+
+        // idempotent and process-wide: an entry whose table is already installed,
+        // by this bank or another, keeps its row and its runtime id. a builtin
+        // curve given a different table switches to it; the old row stays, as
+        // lock-free readers may still hold it. returns the entries installed or
+        // kept, -1 when not open
+        int install() {
+            if( !ok() ) {
+                return -1;
+            }
+            static std::mutex lock;
+            static std::vector<std::shared_ptr<detail::mapping> > &installed = *new std::vector<std::shared_ptr<detail::mapping> >; /* never unmapped */
+            std::lock_guard<std::mutex> guard( lock );
+            bool used = false;
+            int done = 0;
+            for( size_t i = 0; i < count; ++i ) {
+                const detail::bank_row r = row( i );
+                if( entries[i].type >= 0 ) {
+                    std::atomic<const detail::bank_row *> &slot = detail::bank_rows()[ entries[i].type ];
+                    if( !same( slot.load( std::memory_order_acquire ), r ) ) {
+                        slot.store( new detail::bank_row( r ), std::memory_order_release );
+                        used = true;
+                    }
+                    ids[i] = entries[i].type;
+                } else {
+                    ids[i] = -1;
+                    for( int id = UNDEFINED + 1; const detail::custom_curve *c = detail::find_curve( id ); ++id ) {
+                        if( c->name == entries[i].name && same( c->row, r ) ) {
+                            ids[i] = id;
+                            break;
+                        }
+                    }
+                    if( ids[i] < 0 ) {
+                        const detail::bank_row *p = new detail::bank_row( r );
+                        ids[i] = detail::add_curve( entries[i].name, [p]( double t ) { return p->linear( t ); }, p );
+                        if( ids[i] < 0 ) {
+                            delete p;
+                        } else {
+                            used = true;
+                        }
+                    }
+                }
+                done += ids[i] >= 0;
+            }
+            if( used ) {
+                installed.push_back( map );
+            }
+            return done;
+        }
+    };
 }